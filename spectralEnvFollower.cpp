@@ -2,17 +2,37 @@
  * Spectre - Spectral Envelope Follower (3-Band)
  * ----------------------------------------------
  *
- * - Uses a fast ARM-optimised FFT (e.g. KissFFT or CMSIS-DSP – compiled
- *   separately and **statically linked**).
+ * - Uses its own FFT engines (radix-2, Stockham and mixed radix), with
+ *   twiddles from one shared cosine table.
  * - Analyses an incoming audio signal and tracks the energy in three
  *   user-selectable frequency bands.
  * - The energy of each band is output on three CV outputs (0-10 V).
  * - The three pots choose the *centre* frequency of each band.  Bands may
  *   overlap freely.
  * - Encoder L scales the Y-axis of the spectrum view (×½ / ×2 per detent).
- * - Encoder R steps through FFT sizes 256 → 512 → 1024 → 2048 (and wraps).
+ * - Encoder R toggles the detection mode (RMS ↔ Peak); the FFT size is the
+ *   FFT Size parameter.
  * - The custom UI draws a bar chart of the current FFT magnitudes with
  *   bold markers at the three band centres.
+ * - Optional band-split audio outputs: complementary spectral masks (summing
+ *   back to the input) resynthesised with inverse FFTs and overlap-add.
+ * - Spectral freeze: a gate latches the magnitude spectrum (and holds the band
+ *   CVs); the freeze output resynthesises it with random or advancing phases.
+ * - Spectral denoiser: a per-bin soft gate against a tracked noise floor,
+ *   smoothed in time and frequency, on its own audio output.
+ * - Channel vocoder: a carrier input shares the analysis FFT (packed into the
+ *   imaginary half) and is shaped by the input's smoothed band envelope.
+ * - Selectable FFT engine: in-place radix-2 with bit reversal, or a Stockham
+ *   autosort kernel (sequential access, one extra work buffer).
+ * - Selectable FFT size, including mixed-radix (2/3/5) sizes such as 480, 960
+ *   and 1920 that give whole-millisecond frames at 48 kHz.
+ * - Output-pruned FFT for band-only use (display off, no audio outputs): only
+ *   the butterflies feeding the band bins run, chosen by a cost model.
+ * - Constant-Q analysis (Brown–Puckette sparse spectral kernel on top of the
+ *   FFT) for the bands and the display: 256 log-spaced bins, 20 Hz-20 kHz.
+ * - Time-frequency reassignment: time-ramped and derivative-window transforms
+ *   (one packed FFT, same loader pass) give each bin a reassigned frequency
+ *   and time, used for sub-bin band peaks.
  *
  * 2025 © Thorinside / Example code produced by ChatGPT-o3.
  * Released under the MIT Licence.
@@ -33,12 +53,98 @@ extern "C" int* __errno(void) {
     return &errno_val;
 }
 
+#ifdef SPECTRE_BIT_EXACT
+// -----------------------------------------------------------------------------
+// Bit-exact math (make REPRO=1)
+// -----------------------------------------------------------------------------
+// newlib on the module and the host libm round their transcendentals
+// differently, so the reproducible build swaps them for the versions below.
+// They use only + - * /, floorf and bit casts in a fixed order; with
+// -ffp-contract=off and no -ffast-math every IEEE-754 single-precision target
+// gives the same bits.  Errors stay near 1e-6 relative over the argument
+// ranges this file uses.  sqrtf, fabsf, floorf, ceilf and roundf are exact
+// everywhere and stay as they are.
+
+static inline float exactBitsToFloat(uint32_t u) { float f; memcpy(&f, &u, sizeof(f)); return f; }
+static inline uint32_t exactFloatToBits(float f) { uint32_t u; memcpy(&u, &f, sizeof(u)); return u; }
+
+// 2^x = 2^k · e^(r·ln2) with k the nearest integer, |r| ≤ 0.5, degree-7 Taylor
+static inline float exactExp2f(float x)
+{
+    if (!(x > -126.0f)) return 0.0f;          // underflow (no subnormals) and NaN
+    if (x > 127.0f) x = 127.0f;
+    const float k = floorf(x + 0.5f);
+    const float t = (x - k) * 0.693147181f;
+    const float p = 1.0f + t * (1.0f + t * (0.5f + t * (1.66666667e-1f + t * (4.16666667e-2f
+                  + t * (8.33333333e-3f + t * (1.38888889e-3f + t * 1.98412698e-4f))))));
+    return p * exactBitsToFloat((uint32_t)((int)k + 127) << 23);
+}
+
+// log2(x) = e + ln(m)/ln2 with m in [√½, √2) and ln(m) = 2·atanh((m-1)/(m+1))
+static inline float exactLog2f(float x)
+{
+    if (!(x > 0.0f)) return -HUGE_VALF;
+    int e = 0;
+    if (x < 1.17549435e-38f) { x *= 8388608.0f; e = -23; }   // subnormal input
+    const uint32_t u = exactFloatToBits(x);
+    e += (int)(u >> 23) - 127;
+    float m = exactBitsToFloat((u & 0x007FFFFFu) | 0x3F800000u);
+    if (m > 1.41421356f) { m *= 0.5f; e += 1; }
+    const float s = (m - 1.0f) / (m + 1.0f);
+    const float s2 = s * s;
+    const float ln = s * (2.0f + s2 * (6.66666667e-1f + s2 * (4.0e-1f
+                   + s2 * (2.85714286e-1f + s2 * 2.22222222e-1f))));
+    return (float)e + ln * 1.44269504f;
+}
+
+static inline float exactExpf(float x) { return exactExp2f(x * 1.44269504f); }
+static inline float exactLogf(float x) { return exactLog2f(x) * 0.693147181f; }
+
+// Positive bases only – every powf() here raises 2 or 10
+static inline float exactPowf(float base, float y)
+{
+    if (!(base > 0.0f)) return 0.0f;
+    return exactExp2f(y * exactLog2f(base));
+}
+
+// Shared reduction r = x - k·π/2 (|r| ≤ π/4, π/2 split so k·hi is exact for
+// |k| < 2^15), then the quadrant picks ±sin(r) or ±cos(r)
+static inline float exactSinCos(float x, int quadrantOffset)
+{
+    const float k = floorf(x * 0.636619772f + 0.5f);
+    const float r = (x - k * 1.5703125f) - k * 4.83826792e-4f;
+    const float r2 = r * r;
+    const float s = r + r * r2 * (-1.66666667e-1f + r2 * (8.33333333e-3f
+                  + r2 * (-1.98412698e-4f + r2 * 2.75573192e-6f)));
+    const float c = 1.0f + r2 * (-0.5f + r2 * (4.16666667e-2f + r2 * (-1.38888889e-3f
+                  + r2 * (2.48015873e-5f - r2 * 2.75573192e-7f))));
+    switch (((int)k + quadrantOffset) & 3) {
+        case 0:  return s;
+        case 1:  return c;
+        case 2:  return -s;
+        default: return -c;
+    }
+}
+
+static inline float exactSinf(float x) { return exactSinCos(x, 0); }
+static inline float exactCosf(float x) { return exactSinCos(x, 1); }
+
+#define expf  exactExpf
+#define logf  exactLogf
+#define exp2f exactExp2f
+#define log2f exactLog2f
+#define powf  exactPowf
+#define sinf  exactSinf
+#define cosf  exactCosf
+#endif  // SPECTRE_BIT_EXACT
+
 // -----------------------------------------------------------------------------
 // CONFIGURATION CONSTANTS
 // -----------------------------------------------------------------------------
 
-static const int kFftSize                = 512;           // Fixed 512-point FFT
-static const int kFftRateHz              = 5;             // FFT update rate (Hz)
+static const int kMaxFftSize             = 2048;          // Largest selectable FFT
+static const int kDefaultFftSize         = 512;           // FFT size before parameterChanged()
+static const int kFftRateHz              = 5;             // minimum CV-only FFT rate (Hz)
 static const float kMinAttackMs          = 1.0f;          // 1 ms minimum attack
 static const float kMaxAttackMs          = 1000.0f;       // 1 second maximum attack
 static const float kMinReleaseMs         = 10.0f;         // 10 ms minimum release
@@ -47,23 +153,120 @@ static const float kReferenceVoltage     = 10.0f;         // 10 V full-scale
 static const float kMinPotFreq           = 20.0f;         // 20 Hz lower limit
 static const float kMaxPotFreq           = 20000.0f;      // 20 kHz upper limit
 
-// Precomputed factors for the 512-sample Hann window used before the FFT.
-static const float kHannWindowSum        = 0.5f * ((float)kFftSize - 1.0f);   // Σ Hann[n]
-static const float kHannWindowRmsGain    = 0.6117741f;                        // √(Σ Hann[n]^2 / N)
-static const float kFftRmsNormalization  = 1.0f / ((float)kFftSize * kHannWindowRmsGain);
-static const float kPeakNormPositive     = 2.0f / kHannWindowSum;             // For mirrored bins
-static const float kPeakNormEdge         = 1.0f / kHannWindowSum;             // For DC / Nyquist bins
+// Periodic Hann window: Σ Hann[n] = N/2 for any N, so the size-dependent
+// normalisation factors are derived from these in configureFftSize().
+static const float kHannWindowRmsGain    = 0.6123724f;                        // √(Σ Hann[n]^2 / N) = √(3/8)
 static const float kSqrtTwo              = 1.41421356f;
 
-// Compile-time memory safety checks
-static_assert(kFftSize == 512, "FFT size must be 512");
-static_assert(kFftSize % 2 == 0, "FFT size must be even");
-static_assert(kFftSize / 2 == 256, "Half FFT size must be 256 for display width");
+// Selectable FFT sizes – every entry must factor into 2, 3 and 5 and be a
+// multiple of 4 (quarter-period sine lookups, 75% overlap hop).
+static constexpr int kFftSizes[]         = { 256, 480, 512, 960, 1024, 1920, 2048 };
+static const int kNumFftSizes            = sizeof(kFftSizes) / sizeof(kFftSizes[0]);
+static const int kDefaultFftSizeIndex    = 2;                                 // 512
+static const int kMaxFftFactors          = 12;                                // radix passes per plan
+// Window Length – the analysis window covers the newest N/P samples and the
+// rest of the frame is zero padding (interpolated spectrum).
+static constexpr int kWindowDivisors[]   = { 1, 2, 4, 8 };
+static const int kNumWindowLengths       = sizeof(kWindowDivisors) / sizeof(kWindowDivisors[0]);
+// Polyphase (WOLA) analysis – a kWolaTaps·N prototype folded into N samples.
+// Root-raised-cosine bins are power complementary, so band sums stay flat.
+static const int kWolaTaps               = 4;
+static const float kWolaRolloff          = 1.0f;                              // RRC excess bandwidth (β)
+// Adaptive window – transient frames are analysed with the newest N/8 samples
+static const int kAdaptiveDivisor        = 8;                                 // 2048 → 256 points
+static const float kTransientRatio       = 4.0f;                              // newest block 6 dB over the rest
+static const float kTransientFloor       = 1e-6f;                             // mean power (V²) ignored below
+// Input decimation – cascaded half-band stages ahead of the ring buffer
+static const int kMaxDecimationStages    = 3;                                 // up to ÷8
+static const float kDecimationPassband   = 0.35f;                             // usable fraction of the decimated rate
+// CV response curves – interpolated lookup table per output
+static const int kCurveSegments          = 32;                                // table has kCurveSegments + 1 points
+static const float kCurveExpRate         = 4.0f;                              // exp/log curvature (e^4 ≈ 55:1)
+// Gate outputs – hysteresis comparators on the band envelopes
+static const float kGateHighVolts        = 5.0f;
+static const int kMaxGateEdges           = 4;                                 // edges kept per band per block
+// Onset triggers – frame-level rise detection, placed by a time-domain scan
+static const float kOnsetFloor           = 0.02f;                             // ignore rises below -34 dBFS
+static const int kOnsetScanBlock         = 16;                                // energy scan resolution (ring samples)
+static const float kOnsetScanRatio       = 2.0f;                              // block-to-block energy step for a hit
+static const int kMaxPendingTriggers     = 4;                                 // queued onsets per band
+// Max-hold outputs – monotonic deque of per-frame envelopes
+static const int kHoldCapacity           = 1024;                              // entries per band (power of two)
+// Derived outputs – loudest band, energy shares and low/high balance
+static const float kLoudestStepVolts     = 1.0f;                              // A = 0 V, B = 1 V, C = 2 V
+static const float kDerivedFloor         = 0.001f;                            // below this the bands are silent
+// Envelope scope – one 8-bit column per display pixel
+static const int kScopeColumns           = 256;
+// Trace recorder – lossless input/parameter log in a DRAM ring of words
+static const int kTraceWords             = 65536;                             // ring capacity (256 KB)
+static const int kTraceScratchWords      = 8192;                              // one encoded block record
+static const int kTraceMaxParams         = 256;
+static const int kTraceRiceEscape        = 24;                                // unary cap before a raw value
+enum {
+    kTraceTagBlock = 1,             // framesBy4, stream flags, coded streams
+    kTraceTagParam = 2,             // parameter index, value
+    kTraceTagGap   = 3,             // block too large to record
+    kTraceTagRate  = 4,             // sample rate (Hz)
+};
+
+// Overlap-add resynthesis used by the audio outputs.
+static const int kMaxNumBins             = kMaxFftSize / 2 + 1;               // DC..Nyquist inclusive
+static const int kMaxHopSize             = kMaxFftSize / 4;                   // 75% overlap
+static const float kOlaGain              = 2.0f / 3.0f;                       // 1 / Σ Hann^2 at 75% overlap
+static const float kMinCrossoverOctaves  = 0.05f;                             // narrowest crossover slope
+static const float kGateThreshold        = 1.0f;                              // gate input high level (V)
+static const float kNoiseFloorRiseDbPerSec = 6.0f;                           // noise floor creeps up slowly
+static const float kNoiseFloorFallMs     = 100.0f;                            // ...and drops quickly to minima
+static const float kNoiseFloorBias       = 4.2f;                              // noise mean / tracked floor at these rates
+static const float kDenoiseReleaseMs     = 80.0f;                             // gate gain closing time
+static const float kNoiseFloorMin        = 1e-12f;                            // keeps the floor non-zero
+static const int kNoiseLearnFrames       = 32;                                // frames averaged to seed the floor
+static const int kMaxVocoderBands        = 32;                                // filterbank size limit
+static const float kVocoderMinHz         = 80.0f;                             // lowest vocoder band edge
+static const float kVocoderMaxHz         = 12000.0f;                          // highest vocoder band edge
+static const float kDisplayIdleMs        = 250.0f;                            // no draw() for this long → display off
+// Pruned-FFT cost model for Pruning = Auto, in units of one butterfly of a
+// fully used stage.  Provisional host figures (-Os -ffast-math, x86-64) from
+// `make bench`, which prints the measured ratios beside these: a masked
+// butterfly costs ~2-3 of those, the table-driven radix-2 and Stockham
+// kernels ~1.  Not yet measured on the Cortex-M7, so Auto is opt-in and
+// pruning defaults to Off.
+static const float kPrunedSparseCost     = 3.0f;
+static const float kFullCostRadix2       = 1.0f;
+static const float kFullCostStockham     = 1.0f;
+static const float kPruneMinSaving       = 0.8f;                              // prune only below 80% of full cost
+enum { kPruneOff = 0, kPruneAuto, kPruneOn };                                 // Pruning parameter
+// Constant-Q analysis – one bin per display pixel, equal ratio spacing.
+static const int kCqBins                 = 256;
+static const int kCqBinsPerStep          = 2;                                 // kernel bins built per block after a rate switch
+static const float kCqMinHz              = 20.0f;
+static const float kCqMaxHz              = 20000.0f;
+static const float kCqKernelThreshold    = 0.0054f;                           // drop kernel entries below this × peak
+static const int kMaxCqKernelEntries     = 16384;                             // sparse kernel pool (all bins)
+
+// Resynthesis channels – one overlap-add accumulator per audio output.
+enum
+{
+    kSynthBandA = 0, kSynthBandB, kSynthBandC,
+    kSynthFreeze,
+    kSynthDenoise,
+    kSynthVocoder,
+    kNumSynthChannels
+};
 
-// No need for separate function pointers - we'll use the generic arm_cfft_init_f32()
+// Compile-time memory safety checks
+static_assert(kMaxFftSize % 4 == 0, "FFT size must be a multiple of 4");
+static_assert(kMaxFftSize / 2 >= 256, "Half FFT size must cover the display width");
+static_assert(kFftSizes[kDefaultFftSizeIndex] == kDefaultFftSize, "Default FFT size mismatch");
+static_assert(kMaxFftSize <= 65536, "Freeze phases are stored as 16-bit table indices");
+static_assert(kCqBins == 256, "One constant-Q bin per display pixel");
+static_assert(kMaxCqKernelEntries <= 65535, "Constant-Q kernel rows use 16-bit offsets");
+static_assert(kFftSizes[0] / kWindowDivisors[kNumWindowLengths - 1] % 4 == 0, "Window length must be a multiple of 4");
+static_assert(kFftSizes[0] % kAdaptiveDivisor == 0, "Short frames must divide every FFT size");
 
 // -----------------------------------------------------------------------------
-// Simple table-free FFT implementation (radix-2, in-place)
+// FFT primitives – complex type, bit reversal and the in-place radix-2
+// transform, with twiddles from the shared cosine table
 // -----------------------------------------------------------------------------
 
 // Complex number structure
@@ -80,7 +283,7 @@ struct Complex {
 // Bit-reverse function for FFT reordering
 static void bitReverse(Complex* data, int n) {
     // Validate inputs
-    if (!data || n <= 0 || n > kFftSize) return;
+    if (!data || n <= 0 || n > kMaxFftSize) return;
     
     int j = 0;
     for (int i = 1; i < n; i++) {
@@ -98,74 +301,782 @@ static void bitReverse(Complex* data, int n) {
     }
 }
 
-// Simple in-place radix-2 FFT with on-the-fly twiddle computation
-static void simpleFFT(Complex* data, int n) {
+// Simple in-place radix-2 FFT.  Twiddles come from the cosine table, as in
+// stockhamFFT(): exp(-2πi·j/len) is table entry j·n/len.
+static void simpleFFT(Complex* data, const float* cosTable, int n) {
     // Validate inputs
-    if (!data || n <= 0 || n > kFftSize) return;
+    if (!data || !cosTable || n <= 0 || n > kMaxFftSize) return;
     
     bitReverse(data, n);
     
+    const int mask = n - 1;
+    const int quarter = n / 4;
     for (int len = 2; len <= n; len <<= 1) {
-        float angle = -2.0f * M_PI_F / len;
-        Complex wlen(cosf(angle), sinf(angle));
+        const int step = n / len;
         
         for (int i = 0; i < n; i += len) {
-            Complex w(1, 0);
             for (int j = 0; j < len / 2; j++) {
+                const int t = j * step;
+                const Complex w(cosTable[t], -cosTable[(t - quarter) & mask]);
                 Complex u = data[i + j];
                 Complex v = data[i + j + len / 2] * w;
                 data[i + j] = u + v;
                 data[i + j + len / 2] = u - v;
-                w = w * wlen;
             }
         }
     }
 }
 
-// Real-to-complex FFT wrapper (input: real samples, output: complex spectrum)
-static void realFFT(float* realInput, Complex* complexOutput, int n) {
+// -----------------------------------------------------------------------------
+// Stockham autosort FFT (radix-2, decimation in frequency)
+// -----------------------------------------------------------------------------
+// Ping-pongs between data and an n-point work buffer.  Every pass reads and
+// writes with unit stride in its inner loop and the output lands in natural
+// order, so there is no bit-reversal pass.  Twiddles come from an n-point
+// cosine table: exp(-2πi·m/n) = cos[m] - i·cos[m - n/4].
+static void stockhamFFT(Complex* data, Complex* work, const float* cosTable, int n) {
     // Validate inputs
-    if (!realInput || !complexOutput || n <= 0 || n > kFftSize) return;
-    
-    // Copy real input to complex array (imaginary parts = 0)
+    if (!data || !work || !cosTable || n <= 1 || n > kMaxFftSize) return;
+
+    const int mask = n - 1;
+    const int quarter = n / 4;
+    Complex* src = data;
+    Complex* dst = work;
+
+    // l = current sub-transform length, s = stride (l · s == n)
+    for (int l = n, s = 1; l > 1; l >>= 1, s <<= 1) {
+        const int m = l / 2;
+        for (int p = 0; p < m; p++) {
+            // exp(-2πi·p/l) == table entry p·s
+            const int t = p * s;
+            const Complex wp(cosTable[t], -cosTable[(t - quarter) & mask]);
+            const Complex* a0 = src + s * p;
+            const Complex* a1 = src + s * (p + m);
+            Complex* b0 = dst + s * (2 * p);
+            Complex* b1 = dst + s * (2 * p + 1);
+            for (int q = 0; q < s; q++) {
+                b0[q] = a0[q] + a1[q];
+                b1[q] = (a0[q] - a1[q]) * wp;
+            }
+        }
+        Complex* tmp = src; src = dst; dst = tmp;
+    }
+
+    // Odd number of passes leaves the result in the work buffer
+    if (src != data) {
+        memcpy(data, src, sizeof(Complex) * n);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Mixed-radix Stockham FFT (radix 4, 2, 3 and 5)
+// -----------------------------------------------------------------------------
+// Same autosort structure as stockhamFFT(), generalised to radix R: each pass
+// splits a length-l sub-transform into R interleaved length-l/R ones.  The
+// factor list is planned once per size (planFFT) and the twiddle for output
+// j of group p is table entry p·j·s, which is always < n.
+static void mixedRadixFFT(Complex* data, Complex* work, const float* cosTable,
+                          const uint8_t* factors, int numFactors, int n) {
+    // Validate inputs
+    if (!data || !work || !cosTable || !factors || n <= 1 || n > kMaxFftSize) return;
+
+    // DFT constants for the odd radices
+    const float c3 = -0.5f;                      // cos(2π/3)
+    const float s3 = 0.866025404f;               // sin(2π/3)
+    const float c51 = 0.309016994f;              // cos(2π/5)
+    const float c52 = -0.809016994f;             // cos(4π/5)
+    const float s51 = 0.951056516f;              // sin(2π/5)
+    const float s52 = 0.587785252f;              // sin(4π/5)
+
+    const int quarter = n / 4;
+    Complex* src = data;
+    Complex* dst = work;
+
+    int l = n;
+    int s = 1;
+    for (int f = 0; f < numFactors; f++) {
+        const int radix = factors[f];
+        const int m = l / radix;
+        for (int p = 0; p < m; p++) {
+            // Twiddles exp(-2πi·p·j/l) for j = 1..radix-1
+            Complex w[5];
+            for (int j = 1; j < radix; j++) {
+                int t = p * j * s;
+                int ts = t - quarter;
+                if (ts < 0) ts += n;
+                w[j] = Complex(cosTable[t], -cosTable[ts]);
+            }
+            for (int q = 0; q < s; q++) {
+                const Complex* a = src + q + s * p;
+                Complex* b = dst + q + s * radix * p;
+                const int sm = s * m;
+                if (radix == 4) {
+                    Complex a0 = a[0], a1 = a[sm], a2 = a[2 * sm], a3 = a[3 * sm];
+                    Complex t0 = a0 + a2, t1 = a0 - a2;
+                    Complex t2 = a1 + a3, t3 = a1 - a3;
+                    Complex t3j(t3.imag, -t3.real);              // -i·t3
+                    b[0] = t0 + t2;
+                    b[s] = (t1 + t3j) * w[1];
+                    b[2 * s] = (t0 - t2) * w[2];
+                    b[3 * s] = (t1 - t3j) * w[3];
+                } else if (radix == 2) {
+                    Complex a0 = a[0], a1 = a[sm];
+                    b[0] = a0 + a1;
+                    b[s] = (a0 - a1) * w[1];
+                } else if (radix == 3) {
+                    Complex a0 = a[0], a1 = a[sm], a2 = a[2 * sm];
+                    Complex sum = a1 + a2, dif = a1 - a2;
+                    Complex mid(a0.real + c3 * sum.real, a0.imag + c3 * sum.imag);
+                    Complex rot(s3 * dif.imag, -s3 * dif.real);  // -i·sin(2π/3)·dif
+                    b[0] = a0 + sum;
+                    b[s] = (mid + rot) * w[1];
+                    b[2 * s] = (mid - rot) * w[2];
+                } else {
+                    Complex a0 = a[0], a1 = a[sm], a2 = a[2 * sm], a3 = a[3 * sm], a4 = a[4 * sm];
+                    Complex s14 = a1 + a4, d14 = a1 - a4;
+                    Complex s23 = a2 + a3, d23 = a2 - a3;
+                    Complex m1(a0.real + c51 * s14.real + c52 * s23.real,
+                               a0.imag + c51 * s14.imag + c52 * s23.imag);
+                    Complex m2(a0.real + c52 * s14.real + c51 * s23.real,
+                               a0.imag + c52 * s14.imag + c51 * s23.imag);
+                    // -i·(sin terms)
+                    Complex r1(s51 * d14.imag + s52 * d23.imag, -(s51 * d14.real + s52 * d23.real));
+                    Complex r2(s52 * d14.imag - s51 * d23.imag, -(s52 * d14.real - s51 * d23.real));
+                    b[0] = a0 + s14 + s23;
+                    b[s] = (m1 + r1) * w[1];
+                    b[2 * s] = (m2 + r2) * w[2];
+                    b[3 * s] = (m2 - r2) * w[3];
+                    b[4 * s] = (m1 - r1) * w[4];
+                }
+            }
+        }
+        Complex* tmp = src; src = dst; dst = tmp;
+        l = m;
+        s *= radix;
+    }
+
+    // Odd number of passes leaves the result in the work buffer
+    if (src != data) {
+        memcpy(data, src, sizeof(Complex) * n);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Output-pruned FFT (radix-2 DIT, in place)
+// -----------------------------------------------------------------------------
+// Same structure as simpleFFT(), but each stage only runs the butterflies set
+// in its mask (planned by planPrunedFFT); everything else is never read by a
+// wanted output bin.  Butterfly id = (i/len)·(len/2) + j.  Twiddles come from
+// the cosine table because skipped butterflies would break the recurrence.
+static const int kMaxFftStages = 11;            // log2(2048)
+
+static void prunedFFT(Complex* data, const float* cosTable,
+                      const uint32_t (*stageMask)[kMaxFftSize / 64], int n) {
+    // Validate inputs
+    if (!data || !cosTable || !stageMask || n <= 1 || n > kMaxFftSize) return;
+
+    const int quarter = n / 4;
+    const int words = (n / 2 + 31) / 32;
+
+    bitReverse(data, n);
+
+    int stage = 0;
+    for (int len = 2; len <= n; len <<= 1, stage++) {
+        const int half = len / 2;
+        const int step = n / len;
+
+        // Fully used stage – plain loops, one twiddle per j
+        bool full = true;
+        for (int wi = 0; wi < words && full; wi++) {
+            full = (stageMask[stage][wi] == 0xFFFFFFFFu);
+        }
+        if (full) {
+            for (int j = 0; j < half; j++) {
+                const int t = j * step;
+                int ts = t - quarter;
+                if (ts < 0) ts += n;
+                const Complex w(cosTable[t], -cosTable[ts]);
+                for (int p = j; p < n; p += len) {
+                    Complex u = data[p];
+                    Complex v = data[p + half] * w;
+                    data[p] = u + v;
+                    data[p + half] = u - v;
+                }
+            }
+            continue;
+        }
+
+        for (int wi = 0; wi < words; wi++) {
+            uint32_t bits = stageMask[stage][wi];
+            while (bits) {
+                const int id = wi * 32 + __builtin_ctz(bits);
+                bits &= bits - 1;
+                const int j = id & (half - 1);
+                const int p = ((id - j) << 1) + j;
+                // exp(-2πi·j/len) == table entry j·step
+                const int t = j * step;
+                int ts = t - quarter;
+                if (ts < 0) ts += n;
+                const Complex w(cosTable[t], -cosTable[ts]);
+                Complex u = data[p];
+                Complex v = data[p + half] * w;
+                data[p] = u + v;
+                data[p + half] = u - v;
+            }
+        }
+    }
+}
+
+// Mark, stage by stage from the output backwards, the butterflies that feed
+// the wanted bins.  binLo/binHi give up to numRanges inclusive bin ranges.
+// Returns the number of butterflies kept.  Configuration time only.
+static int planPrunedFFT(uint32_t (*stageMask)[kMaxFftSize / 64], int n,
+                         const int* binLo, const int* binHi, int numRanges) {
+    uint32_t needed[kMaxFftSize / 32];
+    const int words = n / 32;
+    for (int w = 0; w < words; w++) needed[w] = 0;
+    for (int r = 0; r < numRanges; r++) {
+        for (int k = binLo[r]; k <= binHi[r]; k++) {
+            if (k >= 0 && k < n) needed[k >> 5] |= 1u << (k & 31);
+        }
+    }
+
+    int stages = 0;
+    while ((2 << stages) <= n) stages++;
+
+    int count = 0;
+    for (int stage = stages - 1; stage >= 0; stage--) {
+        const int half = 1 << stage;
+        for (int w = 0; w < (n / 2 + 31) / 32; w++) stageMask[stage][w] = 0;
+        for (int id = 0; id < n / 2; id++) {
+            const int j = id & (half - 1);
+            const int p = ((id - j) << 1) + j;
+            const int q = p + half;
+            bool used = ((needed[p >> 5] >> (p & 31)) & 1) || ((needed[q >> 5] >> (q & 31)) & 1);
+            if (used) {
+                stageMask[stage][id >> 5] |= 1u << (id & 31);
+                needed[p >> 5] |= 1u << (p & 31);
+                needed[q >> 5] |= 1u << (q & 31);
+                count++;
+            }
+        }
+    }
+    return count;
+}
+
+// Selected FFT implementation and the resources it needs.
+enum { kFftEngineRadix2 = 0, kFftEngineStockham, kFftEngineMixedRadix };
+
+struct FftEngine {
+    int type;               // kFftEngineRadix2 / kFftEngineStockham / kFftEngineMixedRadix
+    Complex* work;          // Stockham ping-pong buffer (n points)
+    const float* cosTable;  // cos(2πi/n) twiddle table
+    uint8_t factors[kMaxFftFactors];  // mixed-radix pass plan (planFFT)
+    int numFactors;
+};
+
+// Factorise n into radix-4/2/3/5 passes.  Returns false if n has another
+// prime factor.  Called at configuration time only.
+static bool planFFT(FftEngine& engine, int n) {
+    engine.numFactors = 0;
+    if (n <= 1) return false;
+
+    static const int radices[] = { 4, 2, 3, 5 };
+    for (int r = 0; r < 4; r++) {
+        while (n % radices[r] == 0 && engine.numFactors < kMaxFftFactors) {
+            engine.factors[engine.numFactors++] = (uint8_t)radices[r];
+            n /= radices[r];
+        }
+    }
+    return n == 1;
+}
+
+static inline bool isPowerOfTwo(int n) {
+    return n > 0 && (n & (n - 1)) == 0;
+}
+
+static void runFFT(const FftEngine& engine, Complex* data, int n) {
+    if (engine.type == kFftEngineMixedRadix || !isPowerOfTwo(n)) {
+        mixedRadixFFT(data, engine.work, engine.cosTable, engine.factors, engine.numFactors, n);
+    } else if (engine.type == kFftEngineStockham) {
+        stockhamFFT(data, engine.work, engine.cosTable, n);
+    } else {
+        simpleFFT(data, engine.cosTable, n);
+    }
+}
+
+// Inverse FFT of a packed pair of Hermitian spectra (A + iB).
+// On return the real parts hold IFFT(A) and the imaginary parts IFFT(B).
+static void inverseFFT(const FftEngine& engine, Complex* data, int n) {
+    // Validate inputs
+    if (!data || n <= 0 || n > kMaxFftSize) return;
+
+    // IFFT(x) = conj(FFT(conj(x))) / n
     for (int i = 0; i < n; i++) {
-        complexOutput[i] = Complex(realInput[i], 0);
+        data[i].imag = -data[i].imag;
     }
-    
-    // Perform complex FFT
-    simpleFFT(complexOutput, n);
+
+    runFFT(engine, data, n);
+
+    const float scale = 1.0f / (float)n;
+    for (int i = 0; i < n; i++) {
+        data[i].real *= scale;
+        data[i].imag *= -scale;
+    }
+}
+
+// Separate the spectra of two real signals transformed together as a + ib:
+//   A[k] = (Z[k] + conj(Z[N-k])) / 2,  B[k] = (Z[k] - conj(Z[N-k])) / 2i
+// A replaces Z in place (full, Hermitian); B is written as a half spectrum.
+static void splitPackedSpectrum(Complex* data, Complex* halfB, int n) {
+    // Validate inputs
+    if (!data || !halfB || n <= 0 || n > kMaxFftSize) return;
+
+    const int half = n / 2;
+
+    // DC and Nyquist pair with themselves
+    halfB[0] = Complex(data[0].imag, 0);
+    data[0] = Complex(data[0].real, 0);
+    halfB[half] = Complex(data[half].imag, 0);
+    data[half] = Complex(data[half].real, 0);
+
+    for (int k = 1; k < half; k++) {
+        Complex zk = data[k];
+        Complex zn = data[n - k];
+        Complex a((zk.real + zn.real) * 0.5f, (zk.imag - zn.imag) * 0.5f);
+        halfB[k] = Complex((zk.imag + zn.imag) * 0.5f, (zn.real - zk.real) * 0.5f);
+        data[k] = a;
+        data[n - k] = Complex(a.real, -a.imag);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Half-band decimator – 23-tap Kaiser-windowed (β = 5) half-band lowpass, run
+// polyphase: every other tap is zero, so each output (one per two inputs) is
+// the centre tap plus six symmetric pairs.  Passband to 0.35 of the output
+// rate with 0.03 dB ripple; everything that aliases into it is 54 dB down.
+// -----------------------------------------------------------------------------
+static const int kHalfbandTaps = 23;
+static const int kHalfbandPairs = 6;
+static const float kHalfbandCentre = 0.4999281f;
+static const float kHalfbandCoeffs[kHalfbandPairs] = {
+    0.312432961f, -0.089600722f, 0.039216060f, -0.016678770f, 0.005728586f, -0.001062160f,
+};
+
+struct HalfbandStage {
+    float delay[2 * kHalfbandTaps];    // written twice so the taps read contiguously
+    int   pos;
+    bool  odd;                         // an output is due on the next input
+};
+
+// Push one input; returns true with out set on every second call
+static inline bool halfbandPush(HalfbandStage &s, float x, float &out)
+{
+    s.delay[s.pos] = x;
+    s.delay[s.pos + kHalfbandTaps] = x;
+    if (++s.pos == kHalfbandTaps) s.pos = 0;
+    s.odd = !s.odd;
+    if (s.odd) return false;
+
+    const float *t = &s.delay[s.pos];  // oldest .. newest
+    const int c = kHalfbandTaps / 2;
+    float acc = kHalfbandCentre * t[c];
+    for (int j = 0; j < kHalfbandPairs; j++) {
+        acc += kHalfbandCoeffs[j] * (t[c - 1 - 2 * j] + t[c + 1 + 2 * j]);
+    }
+    out = acc;
+    return true;
+}
+
+// One max-hold deque entry: a frame's envelope and its sample clock
+struct HoldEntry {
+    float value;
+    uint32_t time;
+};
+
+// One non-zero of the constant-Q spectral kernel: conj(K[bin]) / N
+struct CqKernelEntry {
+    uint16_t bin;
+    Complex coeff;
+};
+
+// -----------------------------------------------------------------------------
+// DRAM layout – size-dependent buffers carved from one block.  The DTC holds
+// pointers into it so the hot code indexes them directly.
+// -----------------------------------------------------------------------------
+// planDramLayout() places every buffer at an aligned byte offset computed
+// from the size limits in a LayoutSpec, grouped by subsystem with a byte
+// count per group.  It is constexpr: the default plan (kDramLayout) is fixed
+// at compile time and read by both calculateRequirements() and construct(),
+// and the same function can plan other limits at run time.  The row strides
+// of the 2-D buffers below still come from the compile-time constants.
+struct LayoutSpec {
+    int maxFftSize;                 // largest selectable FFT size
+    int wolaTaps;                   // polyphase prototype length / N
+    int cqBins;
+    int cqKernelEntries;
+    int holdCapacity;               // max-hold deque entries per band
+    int scopeColumns;
+    int traceWords;                 // trace ring
+    int traceScratchWords;
+    int traceMaxParams;
+};
+
+static constexpr LayoutSpec kLayoutSpec = {
+    kMaxFftSize, kWolaTaps, kCqBins, kMaxCqKernelEntries, kHoldCapacity,
+    kScopeColumns, kTraceWords, kTraceScratchWords, kTraceMaxParams,
+};
+
+enum {
+    kLayoutAnalysis = 0,            // input ring, FFT, window and band plans
+    kLayoutSynthesis,               // overlap-add resynthesis
+    kLayoutSpectral,                // freeze, denoise and vocoder
+    kLayoutConstantQ,
+    kLayoutReassign,
+    kLayoutPolyphase,
+    kLayoutHoldScope,               // max-hold deques and scope history
+    kLayoutTrace,
+    kNumLayoutGroups
+};
+
+static const uint32_t kDramAlign = 8;           // every buffer starts on 8 bytes
+
+struct DramLayout {
+    uint32_t inputBuffer, fftOutput, magnitude, cosTable, fftWork, window, bandMask,
+             pruneMask, cosTableSub, padInput, padSub, shortWindow, shortMagnitude;
+    uint32_t synthBuffer, olaBuffer, olaOut;
+    uint32_t carrierBuffer, frozenMag, freezeSpectrum, freezePhase, noiseFloor,
+             denoiseGain, gainScratch, carrierSpectrum, vocoderGain, vocoderBinPos;
+    uint32_t cqKernel, cqKernelStart, cqMagnitude, cqPowerWeight;
+    uint32_t windowRamp, windowDeriv, reassignBuffer, reassignDeriv, reassignFreq, reassignTime;
+    uint32_t wolaWindow, wolaBuffer;
+    uint32_t holdQueue, scopeHistory;
+    uint32_t traceRing, traceScratch, traceTailParams;
+    uint32_t groupBytes[kNumLayoutGroups];      // including alignment padding
+    uint32_t total;                             // bytes to request
+};
+
+// Reserve count T's at the next aligned offset and charge them to group
+template <typename T>
+static constexpr uint32_t layoutPlace(DramLayout &l, int group, int count)
+{
+    const uint32_t at = (l.total + kDramAlign - 1) & ~(kDramAlign - 1);
+    const uint32_t end = at + (uint32_t)sizeof(T) * (uint32_t)count;
+    l.groupBytes[group] += end - l.total;
+    l.total = end;
+    return at;
+}
+
+static constexpr DramLayout planDramLayout(const LayoutSpec &spec)
+{
+    const int n = spec.maxFftSize;
+    const int bins = n / 2 + 1;
+    const int hop = n / 4;
+    int stages = 0;
+    while ((2 << stages) <= n) stages++;
+
+    DramLayout l{};
+    l.inputBuffer     = layoutPlace<float>(l, kLayoutAnalysis, spec.wolaTaps * n);
+    l.fftOutput       = layoutPlace<Complex>(l, kLayoutAnalysis, n);
+    l.magnitude       = layoutPlace<float>(l, kLayoutAnalysis, n / 2);
+    l.cosTable        = layoutPlace<float>(l, kLayoutAnalysis, n);
+    l.fftWork         = layoutPlace<Complex>(l, kLayoutAnalysis, n);
+    l.window          = layoutPlace<float>(l, kLayoutAnalysis, n);
+    l.bandMask        = layoutPlace<float>(l, kLayoutAnalysis, 3 * bins);
+    l.pruneMask       = layoutPlace<uint32_t>(l, kLayoutAnalysis, stages * (n / 64));
+    l.cosTableSub     = layoutPlace<float>(l, kLayoutAnalysis, n / 2);
+    l.padInput        = layoutPlace<Complex>(l, kLayoutAnalysis, n / 2);
+    l.padSub          = layoutPlace<Complex>(l, kLayoutAnalysis, n / 2);
+    l.shortWindow     = layoutPlace<float>(l, kLayoutAnalysis, n / kAdaptiveDivisor);
+    l.shortMagnitude  = layoutPlace<float>(l, kLayoutAnalysis, n / (2 * kAdaptiveDivisor));
+
+    l.synthBuffer     = layoutPlace<Complex>(l, kLayoutSynthesis, n);
+    l.olaBuffer       = layoutPlace<float>(l, kLayoutSynthesis, kNumSynthChannels * n);
+    l.olaOut          = layoutPlace<float>(l, kLayoutSynthesis, kNumSynthChannels * hop);
+
+    l.carrierBuffer   = layoutPlace<float>(l, kLayoutSpectral, spec.wolaTaps * n);
+    l.frozenMag       = layoutPlace<float>(l, kLayoutSpectral, bins);
+    l.freezeSpectrum  = layoutPlace<Complex>(l, kLayoutSpectral, bins);
+    l.freezePhase     = layoutPlace<uint16_t>(l, kLayoutSpectral, bins);
+    l.noiseFloor      = layoutPlace<float>(l, kLayoutSpectral, bins);
+    l.denoiseGain     = layoutPlace<float>(l, kLayoutSpectral, bins);
+    l.gainScratch     = layoutPlace<float>(l, kLayoutSpectral, bins);
+    l.carrierSpectrum = layoutPlace<Complex>(l, kLayoutSpectral, bins);
+    l.vocoderGain     = layoutPlace<float>(l, kLayoutSpectral, bins);
+    l.vocoderBinPos   = layoutPlace<float>(l, kLayoutSpectral, bins);
+
+    l.cqKernel        = layoutPlace<CqKernelEntry>(l, kLayoutConstantQ, spec.cqKernelEntries);
+    l.cqKernelStart   = layoutPlace<uint16_t>(l, kLayoutConstantQ, spec.cqBins + 1);
+    l.cqMagnitude     = layoutPlace<float>(l, kLayoutConstantQ, spec.cqBins);
+    l.cqPowerWeight   = layoutPlace<float>(l, kLayoutConstantQ, spec.cqBins);
+
+    l.windowRamp      = layoutPlace<float>(l, kLayoutReassign, n);
+    l.windowDeriv     = layoutPlace<float>(l, kLayoutReassign, n);
+    l.reassignBuffer  = layoutPlace<Complex>(l, kLayoutReassign, n);
+    l.reassignDeriv   = layoutPlace<Complex>(l, kLayoutReassign, bins);
+    l.reassignFreq    = layoutPlace<float>(l, kLayoutReassign, n / 2);
+    l.reassignTime    = layoutPlace<float>(l, kLayoutReassign, n / 2);
+
+    l.wolaWindow      = layoutPlace<float>(l, kLayoutPolyphase, spec.wolaTaps * n);
+    l.wolaBuffer      = layoutPlace<Complex>(l, kLayoutPolyphase, n);
+
+    l.holdQueue       = layoutPlace<HoldEntry>(l, kLayoutHoldScope, 3 * spec.holdCapacity);
+    l.scopeHistory    = layoutPlace<uint8_t>(l, kLayoutHoldScope, 3 * spec.scopeColumns);
+
+    l.traceRing       = layoutPlace<uint32_t>(l, kLayoutTrace, spec.traceWords);
+    l.traceScratch    = layoutPlace<uint32_t>(l, kLayoutTrace, spec.traceScratchWords);
+    l.traceTailParams = layoutPlace<int16_t>(l, kLayoutTrace, spec.traceMaxParams);
+    return l;
+}
+
+static constexpr DramLayout kDramLayout = planDramLayout(kLayoutSpec);
+
+// The README memory table quotes this plan; `make layout` prints it by group
+static_assert(kDramLayout.total == 893672, "DRAM plan changed: update the README memory table");
+
+static_assert((1 << kMaxFftStages) == kMaxFftSize, "Prune mask rows must match the planned stages");
+
+// Typed view of a planned buffer
+template <typename T>
+static inline T *layoutAt(void *base, uint32_t offset)
+{
+    return reinterpret_cast<T *>(static_cast<uint8_t *>(base) + offset);
 }
 
 // -----------------------------------------------------------------------------
-// DTC (D-TCM) – real-time / large data that benefits from fast access.
+// DTC (D-TCM) – real-time state that benefits from fast access.
 // -----------------------------------------------------------------------------
 struct _SpectralEnvFollower_DTC
 {
-    // Input buffer for real samples (circular buffer)
-    float inputBuffer[kFftSize]     __attribute__((aligned(4)));
+    // Current FFT size and the quantities derived from it (configureFftSize)
+    int   fftSize;                 // N
+    int   numBins;                 // N/2 + 1, DC..Nyquist inclusive
+    int   hopSize;                 // L/4, 75% overlap
+    int   windowLength;            // L = N/P, the newest samples of the frame
+    int   windowDivisor;           // P, Window Length parameter
+    int   shortLength;             // N/8 – adaptive short frames
+    float fftRmsNormalization;     // 1 / (√(N·L) · Hann RMS gain)
+    float peakNormPositive;        // 2 / Σ Hann, for mirrored bins
+    float peakNormEdge;            // 1 / Σ Hann, for DC / Nyquist bins
+    float binRmsScale;             // per-bin RMS → sine amplitude (vocoder)
+    float wolaNormalization;       // 1 / Σ h – polyphase bins (power complementary)
+    int   historySize;             // input ring length: N, or kWolaTaps·N for polyphase
+    int   decimation;              // D – the ring holds the input decimated by D
+    int   decimationStages;        // log2(D) half-band stages in use
+    HalfbandStage decimator[kMaxDecimationStages];
+    int   fftEngineRequested;      // FFT Engine parameter
+
+    // Input buffer for real samples (circular buffer, historySize long)
+    float *inputBuffer;
     
-    // Temporary buffer for FFT processing
-    float tempBuffer[kFftSize]      __attribute__((aligned(4)));
+    // Carrier input (circular buffer, same write index as inputBuffer)
+    float *carrierBuffer;
     
     // FFT output buffer (complex spectrum)
-    Complex fftOutput[kFftSize]     __attribute__((aligned(4)));
+    Complex *fftOutput;
 
     // Per-bin magnitude (half-spectrum)
-    float magnitude[kFftSize/2]     __attribute__((aligned(4)));
+    float *magnitude;
+
+    // FFT engine: cosine/twiddle table (also used for freeze phases) and
+    // the Stockham ping-pong buffer
+    float *cosTable;                // cos(2πi/N)
+    Complex *fftWork;
+    FftEngine fft;
+
+    // Zero-padded frames: P transforms of size L (own twiddle table and
+    // plan, shared work buffer) over the saved non-zero tail.  With a full
+    // window the sub-transform serves the adaptive short frames instead.
+    float *cosTableSub;             // cos(2πi/L), or cos(2πi/(N/8))
+    Complex *padInput;
+    Complex *padSub;
+    FftEngine subFft;
+
+    // Analysis / synthesis window (periodic Hann over the last L samples,
+    // zero before them; rebuilt per FFT size and window length)
+    float *window;
+
+    // Resynthesis: band-split masks, IFFT workspace and overlap-add
+    // accumulators (shared write position for all channels)
+    float (*bandMask)[kMaxNumBins];
+    Complex *synthBuffer;
+    float (*olaBuffer)[kMaxFftSize];
+    float (*olaOut)[kMaxHopSize];
+    int   olaPos;              // start of the current frame in olaBuffer
+    int   hopPos;              // read position in olaOut
+    bool  audioPathsActive;    // any audio output routed
+
+    // Spectral freeze: latched magnitudes only – phases are regenerated
+    // every hop, so a frozen frame costs one inverse FFT.
+    float *frozenMag;
+    Complex *freezeSpectrum;
+    uint16_t *freezePhase;          // phase index into cosTable per bin
+    uint32_t freezeSeed;            // LCG state for random phases
+    bool  frozen;                   // freeze gate currently high
+
+    // Spectral denoiser: tracked per-bin noise power and smoothed gate gain
+    float *noiseFloor;
+    float *denoiseGain;
+    float *gainScratch;
+    float noiseRiseFactor;          // per-frame floor rise multiplier
+    float noiseFallCoeff;           // per-frame floor fall coefficient
+    float denoiseReleaseCoeff;      // per-frame gain release coefficient
+    float denoiseThreshold;         // power ratio above the floor that opens a bin
+    float denoiseMinGain;           // gain applied to fully gated bins
+    int   noiseLearnCount;          // frames averaged into the initial floor
+
+    // Channel vocoder: carrier spectrum (from the packed FFT), filterbank
+    // plan and smoothed modulator band envelopes
+    Complex *carrierSpectrum;
+    float *vocoderGain;
+    float *vocoderBinPos;           // fractional band index per bin
+    float vocoderEnv[kMaxVocoderBands];
+    uint16_t vocoderBandStart[kMaxVocoderBands + 1];             // first bin of each band
+    int   numVocoderBands;
+    int   vocoderBandsRequested;    // Vocoder Bands parameter
+
+    // Output-pruned FFT: per-stage butterfly masks covering the bins of the
+    // bands whose results are used, and whether pruning beats a full FFT
+    uint32_t (*pruneMask)[kMaxFftSize / 64];
+    uint8_t pruneBands;             // bit b set → an output reads band b's envelope
+    bool  pruneWorthwhile;          // Pruning parameter verdict for the current plan
+    int   pruneMode;                // Pruning parameter (kPruneOff / Auto / On)
+    int   displayIdleSamples;       // samples since the last draw()
+
+    // Constant-Q analysis: sparse kernel (rows cqKernelStart[k]..[k+1]),
+    // per-bin magnitude (sine amplitude / 2) and power weights for band RMS
+    CqKernelEntry *cqKernel;
+    uint16_t *cqKernelStart;
+    float *cqMagnitude;
+    float *cqPowerWeight;           // bin spacing / ENBW
+    float cqBinsPerOctave;
+    bool  constantQ;                // Analysis parameter
+    bool  cqKernelValid;            // kernel matches the current size and rate
+    int   cqBuildBin;               // kernel bins below this one are built
+    int   cqBuildEntries;           // kernel entries used by those bins
+    int   cqBandLo[3];              // constant-Q bins summed for band RMS
+    int   cqBandHi[3];
+    int   cqPeakLo[3];              // constant-Q bins searched for band peak
+    int   cqPeakHi[3];
+
+    // Reassignment: time-ramped (n - c)·h and derivative h' windows (c the
+    // window centre), their packed spectrum, and per-bin reassigned frequency
+    // (fractional bins) and time (samples from the window centre, + = later)
+    float *windowRamp;
+    float *windowDeriv;
+    Complex *reassignBuffer;        // X_th (full), then split
+    Complex *reassignDeriv;         // X_dh (half spectrum)
+    float *reassignFreq;
+    float *reassignTime;
+    bool  reassign;                 // Reassignment parameter
+    float bandPeakHz[3];            // frequency of each band's peak bin
+    float bandPeakTime[3];          // its reassigned time (samples from window centre)
+
+    // Polyphase analysis: prototype window (kWolaTaps·N, Σ h = N/2 so bins
+    // read like the Hann FFT) and the folded frame's spectrum when the Hann
+    // frame is also needed for resynthesis
+    float *wolaWindow;
+    Complex *wolaBuffer;
+    bool  polyphase;                // Analysis parameter
+
+    // Adaptive window: short Hann frame, its magnitudes and per-band bin
+    // ranges on the N/8-point grid (RMS ranges span the main lobe)
+    float *shortWindow;
+    float *shortMagnitude;
+    float shortRmsNormalization;    // 1 / (N/8 · Hann RMS gain)
+    float shortPeakNorm;            // 2 / Σ short Hann
+    bool  adaptive;                 // Window Length = Adaptive
+    int   shortPeakLo[3];
+    int   shortPeakHi[3];
+    int   shortBandLo[3];
+    int   shortBandHi[3];
 
     // Envelope followers for the three bands
     float env[3];
 
+    // Response curve per CV output: volts at env = i / kCurveSegments
+    float curveTable[3][kCurveSegments + 1];
+
+    // Gate outputs: hysteresis levels (envelope units), minimum times and
+    // per-band state; edges within the current block are kept for
+    // sample-accurate output
+    float gateOnLevel;
+    float gateOffLevel;
+    uint32_t gateMinOnSamples;
+    uint32_t gateMinOffSamples;
+    uint32_t sampleClock;           // samples since construct (wraps)
+    uint32_t gateEdgeTime[3];       // sampleClock at the last edge
+    bool  gateState[3];
+    bool  gateBlockStart[3];        // state at the start of this block
+    int   gateEdgeCount[3];
+    int   gateEdgePos[3][kMaxGateEdges];
+
+    // Onset triggers: previous raw frame level per band, rise ratio and
+    // pulse state.  Each located onset queues its pulse at the sampleClock
+    // one scan span after it; a frame queues at most one per band and every
+    // delay is under two frame intervals, so the queue never fills.
+    float onsetLevel[3];
+    float onsetRatio;
+    int   triggerSamples;           // pulse length
+    uint32_t triggerDue[3][kMaxPendingTriggers];
+    int   triggerHead[3];
+    int   triggerCount[3];
+    int   triggerRemaining[3];
+
+    // Max-hold: per-band deque rings in DRAM, values decreasing from the
+    // head, so the head is the maximum over the hold window
+    HoldEntry (*holdQueue)[kHoldCapacity];
+    uint32_t holdWindowSamples;
+    uint32_t holdBucketSamples;     // frames this close share one entry
+    int   holdHead[3];
+    int   holdCount[3];
+
+    // Derived outputs: whole-spectrum level (smoothed like the bands) and
+    // the values computed from it and the band envelopes each frame
+    float spectrumEnv;
+    int   loudestBand;
+    float bandShare[3];             // fraction of the total energy
+    float balance;                  // (C - A) / (C + A) energy
+
+    // Envelope scope: per-band CV history (0-10 V → 0-255), one column per
+    // scopeColumnSamples, each the peak over its interval
+    uint8_t (*scopeHistory)[kScopeColumns];
+    int   scopePos;                 // next column to write (oldest shown)
+    int   scopeColumnSamples;
+    int   scopeSampleCount;
+    float scopePeak[3];
+
+    // Trace recorder: records from traceTail (oldest) for traceUsed words.
+    // traceTailParams and traceTailRate hold the parameter values and
+    // sample rate in force at the tail, so an export always starts from a
+    // known state.
+    uint32_t *traceRing;
+    uint32_t *traceScratch;
+    int16_t *traceTailParams;
+    uint32_t traceTailRate;
+    bool  traceActive;
+    int   traceTail;
+    int   traceUsed;
+
     // Envelope follower state
     float attackCoeff;         // calculated from attack time parameter
     float releaseCoeff;        // calculated from release time parameter
+    float attackCoeff2;        // per-stage coefficients of the two-pole smoother
+    float releaseCoeff2;
+    float envStage[3];         // two-pole smoother: first stage
+    bool  twoPole[3];          // per-band smoother choice
+    float attackMs;            // attack time parameter (ms)
+    float releaseMs;           // release time parameter (ms)
 
     // UI & control state
     int   samplesAccumulated;  // how many samples currently in inputBuffer
     int   samplesSinceLastFFT; // counter for FFT rate limiting
+    float sampleRate;          // rate the derived state was built for
     float potCentres[3];       // Hz – centre freq for each band (updated by UI)
     float potCentreBins[3];    // cached centre-bin indices (float) for speed
     float bandwidthOctaves;    // bandwidth in octaves (e.g., 0.333 for 1/3 octave)
+    int   bandLo[3];           // cached bandBinRange() per band (updateBandPlans)
+    int   bandHi[3];
     float yScale;              // vertical scale in UI (multiplier)
     bool  displayInitialized;  // flag to track per-instance display initialization
 };
@@ -194,9 +1105,77 @@ enum
     kParamAttackTime,
     kParamReleaseTime,
     kParamDetectionMode,
+    kParamBandAOut, kParamBandAOutMode,
+    kParamBandBOut, kParamBandBOutMode,
+    kParamBandCOut, kParamBandCOutMode,
+    kParamFreezeGate,
+    kParamFreezeOut, kParamFreezeOutMode,
+    kParamFreezePhase,
+    kParamDenoiseOut, kParamDenoiseOutMode,
+    kParamDenoiseThreshold,
+    kParamDenoiseDepth,
+    kParamCarrierInput,
+    kParamVocoderOut, kParamVocoderOutMode,
+    kParamVocoderBands,
+    kParamFftEngine,
+    kParamFftSize,
+    kParamAnalysis,
+    kParamReassign,
+    kParamWindowLength,
+    kParamBandACurve, kParamBandAMin, kParamBandAMax, kParamBandAOffset,
+    kParamBandBCurve, kParamBandBMin, kParamBandBMax, kParamBandBOffset,
+    kParamBandCCurve, kParamBandCMin, kParamBandCMax, kParamBandCOffset,
+    kParamGateOut1, kParamGateOut1Mode,
+    kParamGateOut2, kParamGateOut2Mode,
+    kParamGateOut3, kParamGateOut3Mode,
+    kParamGateOn,
+    kParamGateOff,
+    kParamGateMinOn,
+    kParamGateMinOff,
+    kParamGateEdges,
+    kParamTrigOut1, kParamTrigOut1Mode,
+    kParamTrigOut2, kParamTrigOut2Mode,
+    kParamTrigOut3, kParamTrigOut3Mode,
+    kParamOnsetThreshold,
+    kParamTriggerLength,
+    kParamHoldOut1, kParamHoldOut1Mode,
+    kParamHoldOut2, kParamHoldOut2Mode,
+    kParamHoldOut3, kParamHoldOut3Mode,
+    kParamHoldTime,
+    kParamLoudestOut, kParamLoudestOutMode,
+    kParamShareOut1, kParamShareOut1Mode,
+    kParamShareOut2, kParamShareOut2Mode,
+    kParamShareOut3, kParamShareOut3Mode,
+    kParamBalanceOut, kParamBalanceOutMode,
+    kParamDisplay,
+    kParamScopeTime,
+    kParamBandASmooth, kParamBandBSmooth, kParamBandCSmooth,
+    kParamTrace,
+    kParamPruning,
 };
 
+// Response curve parameters per band, kParamBandACurve + b * kCurveParamStride
+static const int kCurveParamStride = kParamBandBCurve - kParamBandACurve;
+
 static const char* detectionModeStrings[] = {"RMS", "Peak", nullptr};
+static const char* freezePhaseStrings[] = {"Random", "Advance", nullptr};
+static const char* fftEngineStrings[] = {"Radix-2", "Stockham", "Mixed-Radix", nullptr};
+static const char* analysisStrings[] = {"FFT", "Constant-Q", "Polyphase", nullptr};
+static const char* offOnStrings[] = {"Off", "On", nullptr};
+static const char* fftSizeStrings[] = {"256", "480", "512", "960", "1024", "1920", "2048", nullptr};
+static const char* windowLengthStrings[] = {"Full", "1/2", "1/4", "1/8", "Adaptive", nullptr};
+static const char* curveStrings[] = {"Linear", "Exp", "Log", "S-Curve", nullptr};
+static const char* gateEdgeStrings[] = {"Block", "Sample", nullptr};
+static const char* displayStrings[] = {"Spectrum", "Scope", nullptr};
+static const char* smoothStrings[] = {"1-Pole", "2-Pole", nullptr};
+static const char* traceStrings[] = {"Off", "Record", "Export", nullptr};
+static const char* pruningStrings[] = {"Off", "Auto", "On", nullptr};
+
+// Audio output parameter for each resynthesis channel (mode follows it)
+static const int kSynthOutParam[kNumSynthChannels] = {
+    kParamBandAOut, kParamBandBOut, kParamBandCOut, kParamFreezeOut, kParamDenoiseOut,
+    kParamVocoderOut,
+};
 
 static _NT_parameter gParameters[] = {
     NT_PARAMETER_AUDIO_INPUT("Audio In", 1, 1)
@@ -210,7 +1189,67 @@ static _NT_parameter gParameters[] = {
     { .name = "Attack", .min = 1, .max = 1000, .def = 10, .unit = kNT_unitMs, .scaling = kNT_scalingNone, .enumStrings = nullptr },
     { .name = "Release", .min = 10, .max = 5000, .def = 100, .unit = kNT_unitMs, .scaling = kNT_scalingNone, .enumStrings = nullptr },
     { .name = "Detection", .min = 0, .max = 1, .def = 0, .unit = kNT_unitEnum, .scaling = kNT_scalingNone, .enumStrings = detectionModeStrings },
+    NT_PARAMETER_AUDIO_OUTPUT_WITH_MODE("Band A Out", 0, 0)
+    NT_PARAMETER_AUDIO_OUTPUT_WITH_MODE("Band B Out", 0, 0)
+    NT_PARAMETER_AUDIO_OUTPUT_WITH_MODE("Band C Out", 0, 0)
+    NT_PARAMETER_CV_INPUT("Freeze Gate", 0, 0)
+    NT_PARAMETER_AUDIO_OUTPUT_WITH_MODE("Freeze Out", 0, 0)
+    { .name = "Freeze Phase", .min = 0, .max = 1, .def = 0, .unit = kNT_unitEnum, .scaling = kNT_scalingNone, .enumStrings = freezePhaseStrings },
+    NT_PARAMETER_AUDIO_OUTPUT_WITH_MODE("Denoise Out", 0, 0)
+    { .name = "Gate Threshold", .min = 0, .max = 24, .def = 6, .unit = kNT_unitDb, .scaling = kNT_scalingNone, .enumStrings = nullptr },
+    { .name = "Gate Depth", .min = 0, .max = 60, .def = 30, .unit = kNT_unitDb, .scaling = kNT_scalingNone, .enumStrings = nullptr },
+    NT_PARAMETER_AUDIO_INPUT("Carrier In", 0, 0)
+    NT_PARAMETER_AUDIO_OUTPUT_WITH_MODE("Vocoder Out", 0, 0)
+    { .name = "Vocoder Bands", .min = 4, .max = kMaxVocoderBands, .def = 16, .unit = kNT_unitNone, .scaling = kNT_scalingNone, .enumStrings = nullptr },
+    { .name = "FFT Engine", .min = 0, .max = 2, .def = 0, .unit = kNT_unitEnum, .scaling = kNT_scalingNone, .enumStrings = fftEngineStrings },
+    { .name = "FFT Size", .min = 0, .max = kNumFftSizes - 1, .def = kDefaultFftSizeIndex, .unit = kNT_unitEnum, .scaling = kNT_scalingNone, .enumStrings = fftSizeStrings },
+    { .name = "Analysis", .min = 0, .max = 2, .def = 0, .unit = kNT_unitEnum, .scaling = kNT_scalingNone, .enumStrings = analysisStrings },
+    { .name = "Reassignment", .min = 0, .max = 1, .def = 0, .unit = kNT_unitEnum, .scaling = kNT_scalingNone, .enumStrings = offOnStrings },
+    { .name = "Window Length", .min = 0, .max = kNumWindowLengths, .def = 0, .unit = kNT_unitEnum, .scaling = kNT_scalingNone, .enumStrings = windowLengthStrings },
+    { .name = "Band A Curve", .min = 0, .max = 3, .def = 0, .unit = kNT_unitEnum, .scaling = kNT_scalingNone, .enumStrings = curveStrings },
+    { .name = "Band A Min", .min = -100, .max = 100, .def = 0, .unit = kNT_unitVolts, .scaling = kNT_scaling10, .enumStrings = nullptr },
+    { .name = "Band A Max", .min = -100, .max = 100, .def = 100, .unit = kNT_unitVolts, .scaling = kNT_scaling10, .enumStrings = nullptr },
+    { .name = "Band A Offset", .min = -50, .max = 50, .def = 0, .unit = kNT_unitVolts, .scaling = kNT_scaling10, .enumStrings = nullptr },
+    { .name = "Band B Curve", .min = 0, .max = 3, .def = 0, .unit = kNT_unitEnum, .scaling = kNT_scalingNone, .enumStrings = curveStrings },
+    { .name = "Band B Min", .min = -100, .max = 100, .def = 0, .unit = kNT_unitVolts, .scaling = kNT_scaling10, .enumStrings = nullptr },
+    { .name = "Band B Max", .min = -100, .max = 100, .def = 100, .unit = kNT_unitVolts, .scaling = kNT_scaling10, .enumStrings = nullptr },
+    { .name = "Band B Offset", .min = -50, .max = 50, .def = 0, .unit = kNT_unitVolts, .scaling = kNT_scaling10, .enumStrings = nullptr },
+    { .name = "Band C Curve", .min = 0, .max = 3, .def = 0, .unit = kNT_unitEnum, .scaling = kNT_scalingNone, .enumStrings = curveStrings },
+    { .name = "Band C Min", .min = -100, .max = 100, .def = 0, .unit = kNT_unitVolts, .scaling = kNT_scaling10, .enumStrings = nullptr },
+    { .name = "Band C Max", .min = -100, .max = 100, .def = 100, .unit = kNT_unitVolts, .scaling = kNT_scaling10, .enumStrings = nullptr },
+    { .name = "Band C Offset", .min = -50, .max = 50, .def = 0, .unit = kNT_unitVolts, .scaling = kNT_scaling10, .enumStrings = nullptr },
+    NT_PARAMETER_CV_OUTPUT_WITH_MODE("Band A Gate", 0, 0)
+    NT_PARAMETER_CV_OUTPUT_WITH_MODE("Band B Gate", 0, 0)
+    NT_PARAMETER_CV_OUTPUT_WITH_MODE("Band C Gate", 0, 0)
+    { .name = "Gate On", .min = 0, .max = 100, .def = 50, .unit = kNT_unitPercent, .scaling = kNT_scalingNone, .enumStrings = nullptr },
+    { .name = "Gate Off", .min = 0, .max = 100, .def = 40, .unit = kNT_unitPercent, .scaling = kNT_scalingNone, .enumStrings = nullptr },
+    { .name = "Gate Min On", .min = 0, .max = 1000, .def = 10, .unit = kNT_unitMs, .scaling = kNT_scalingNone, .enumStrings = nullptr },
+    { .name = "Gate Min Off", .min = 0, .max = 1000, .def = 10, .unit = kNT_unitMs, .scaling = kNT_scalingNone, .enumStrings = nullptr },
+    { .name = "Gate Edges", .min = 0, .max = 1, .def = 0, .unit = kNT_unitEnum, .scaling = kNT_scalingNone, .enumStrings = gateEdgeStrings },
+    NT_PARAMETER_CV_OUTPUT_WITH_MODE("Band A Trigger", 0, 0)
+    NT_PARAMETER_CV_OUTPUT_WITH_MODE("Band B Trigger", 0, 0)
+    NT_PARAMETER_CV_OUTPUT_WITH_MODE("Band C Trigger", 0, 0)
+    { .name = "Onset Threshold", .min = 1, .max = 24, .def = 6, .unit = kNT_unitDb, .scaling = kNT_scalingNone, .enumStrings = nullptr },
+    { .name = "Trigger Length", .min = 1, .max = 50, .def = 5, .unit = kNT_unitMs, .scaling = kNT_scalingNone, .enumStrings = nullptr },
+    NT_PARAMETER_CV_OUTPUT_WITH_MODE("Band A Hold", 0, 0)
+    NT_PARAMETER_CV_OUTPUT_WITH_MODE("Band B Hold", 0, 0)
+    NT_PARAMETER_CV_OUTPUT_WITH_MODE("Band C Hold", 0, 0)
+    { .name = "Hold Time", .min = 10, .max = 10000, .def = 500, .unit = kNT_unitMs, .scaling = kNT_scalingNone, .enumStrings = nullptr },
+    NT_PARAMETER_CV_OUTPUT_WITH_MODE("Loudest Band", 0, 0)
+    NT_PARAMETER_CV_OUTPUT_WITH_MODE("Band A Share", 0, 0)
+    NT_PARAMETER_CV_OUTPUT_WITH_MODE("Band B Share", 0, 0)
+    NT_PARAMETER_CV_OUTPUT_WITH_MODE("Band C Share", 0, 0)
+    NT_PARAMETER_CV_OUTPUT_WITH_MODE("Balance", 0, 0)
+    { .name = "Display", .min = 0, .max = 1, .def = 0, .unit = kNT_unitEnum, .scaling = kNT_scalingNone, .enumStrings = displayStrings },
+    { .name = "Scope Time", .min = 1, .max = 10, .def = 4, .unit = kNT_unitSeconds, .scaling = kNT_scalingNone, .enumStrings = nullptr },
+    { .name = "Band A Smooth", .min = 0, .max = 1, .def = 0, .unit = kNT_unitEnum, .scaling = kNT_scalingNone, .enumStrings = smoothStrings },
+    { .name = "Band B Smooth", .min = 0, .max = 1, .def = 0, .unit = kNT_unitEnum, .scaling = kNT_scalingNone, .enumStrings = smoothStrings },
+    { .name = "Band C Smooth", .min = 0, .max = 1, .def = 0, .unit = kNT_unitEnum, .scaling = kNT_scalingNone, .enumStrings = smoothStrings },
+    { .name = "Trace", .min = 0, .max = 2, .def = 0, .unit = kNT_unitEnum, .scaling = kNT_scalingNone, .enumStrings = traceStrings },
+    { .name = "Pruning", .min = 0, .max = 2, .def = 0, .unit = kNT_unitEnum, .scaling = kNT_scalingNone, .enumStrings = pruningStrings },
 };
+static_assert(ARRAY_SIZE(gParameters) <= kTraceMaxParams, "trace snapshot too small");
+static_assert(kMaxDecimationStages <= 5, "trace block flags hold one phase bit per decimator stage");
 
 // Parameter pages
 static const uint8_t routingPage[] = {
@@ -218,20 +1257,91 @@ static const uint8_t routingPage[] = {
     kParamCvOut1, kParamCvOut1Mode,
     kParamCvOut2, kParamCvOut2Mode,
     kParamCvOut3, kParamCvOut3Mode,
+    kParamBandAOut, kParamBandAOutMode,
+    kParamBandBOut, kParamBandBOutMode,
+    kParamBandCOut, kParamBandCOutMode,
+    kParamFreezeGate,
+    kParamFreezeOut, kParamFreezeOutMode,
+    kParamDenoiseOut, kParamDenoiseOutMode,
+    kParamCarrierInput,
+    kParamVocoderOut, kParamVocoderOutMode,
+    kParamGateOut1, kParamGateOut1Mode,
+    kParamGateOut2, kParamGateOut2Mode,
+    kParamGateOut3, kParamGateOut3Mode,
+    kParamTrigOut1, kParamTrigOut1Mode,
+    kParamTrigOut2, kParamTrigOut2Mode,
+    kParamTrigOut3, kParamTrigOut3Mode,
+    kParamHoldOut1, kParamHoldOut1Mode,
+    kParamHoldOut2, kParamHoldOut2Mode,
+    kParamHoldOut3, kParamHoldOut3Mode,
+    kParamLoudestOut, kParamLoudestOutMode,
+    kParamShareOut1, kParamShareOut1Mode,
+    kParamShareOut2, kParamShareOut2Mode,
+    kParamShareOut3, kParamShareOut3Mode,
+    kParamBalanceOut, kParamBalanceOutMode,
 };
 
 static const uint8_t spectralPage[] = {
-    kParamBandAFreq, kParamBandBFreq, kParamBandCFreq,
+    kParamBandAFreq, kParamBandBFreq, kParamBandCFreq, kParamAnalysis, kParamReassign,
 };
 
 static const uint8_t envelopePage[] = {
-    kParamBandwidth, kParamAttackTime, kParamReleaseTime, kParamDetectionMode,
+    kParamBandwidth, kParamAttackTime, kParamReleaseTime, kParamDetectionMode, kParamFftEngine,
+    kParamFftSize, kParamWindowLength, kParamPruning,
+    kParamBandASmooth, kParamBandBSmooth, kParamBandCSmooth,
+};
+
+static const uint8_t responsePage[] = {
+    kParamBandACurve, kParamBandAMin, kParamBandAMax, kParamBandAOffset,
+    kParamBandBCurve, kParamBandBMin, kParamBandBMax, kParamBandBOffset,
+    kParamBandCCurve, kParamBandCMin, kParamBandCMax, kParamBandCOffset,
+};
+
+static const uint8_t gatePage[] = {
+    kParamGateOn, kParamGateOff, kParamGateMinOn, kParamGateMinOff, kParamGateEdges,
+};
+
+static const uint8_t triggerPage[] = {
+    kParamOnsetThreshold, kParamTriggerLength,
+};
+
+static const uint8_t holdPage[] = {
+    kParamHoldTime,
+};
+
+static const uint8_t displayPage[] = {
+    kParamDisplay, kParamScopeTime,
+};
+
+static const uint8_t freezePage[] = {
+    kParamFreezePhase,
+};
+
+static const uint8_t denoisePage[] = {
+    kParamDenoiseThreshold, kParamDenoiseDepth,
+};
+
+static const uint8_t vocoderPage[] = {
+    kParamVocoderBands,
+};
+
+static const uint8_t tracePage[] = {
+    kParamTrace,
 };
 
 static const _NT_parameterPage gPages[] = {
     {.name = "Routing", .numParams = static_cast<uint8_t>(ARRAY_SIZE(routingPage)), .group = 0, .unused = {}, .params = routingPage},
     {.name = "Spectral", .numParams = static_cast<uint8_t>(ARRAY_SIZE(spectralPage)), .group = 0, .unused = {}, .params = spectralPage},
     {.name = "Envelope", .numParams = static_cast<uint8_t>(ARRAY_SIZE(envelopePage)), .group = 0, .unused = {}, .params = envelopePage},
+    {.name = "Response", .numParams = static_cast<uint8_t>(ARRAY_SIZE(responsePage)), .group = 0, .unused = {}, .params = responsePage},
+    {.name = "Gate", .numParams = static_cast<uint8_t>(ARRAY_SIZE(gatePage)), .group = 0, .unused = {}, .params = gatePage},
+    {.name = "Trigger", .numParams = static_cast<uint8_t>(ARRAY_SIZE(triggerPage)), .group = 0, .unused = {}, .params = triggerPage},
+    {.name = "Hold", .numParams = static_cast<uint8_t>(ARRAY_SIZE(holdPage)), .group = 0, .unused = {}, .params = holdPage},
+    {.name = "Display", .numParams = static_cast<uint8_t>(ARRAY_SIZE(displayPage)), .group = 0, .unused = {}, .params = displayPage},
+    {.name = "Trace", .numParams = static_cast<uint8_t>(ARRAY_SIZE(tracePage)), .group = 0, .unused = {}, .params = tracePage},
+    {.name = "Freeze", .numParams = static_cast<uint8_t>(ARRAY_SIZE(freezePage)), .group = 0, .unused = {}, .params = freezePage},
+    {.name = "Denoise", .numParams = static_cast<uint8_t>(ARRAY_SIZE(denoisePage)), .group = 0, .unused = {}, .params = denoisePage},
+    {.name = "Vocoder", .numParams = static_cast<uint8_t>(ARRAY_SIZE(vocoderPage)), .group = 0, .unused = {}, .params = vocoderPage},
 };
 
 static const _NT_parameterPages gParameterPages = {
@@ -266,11 +1376,143 @@ static void calculateRequirements(_NT_algorithmRequirements &req, const int32_t
 {
     req.numParameters = ARRAY_SIZE(gParameters);
     req.sram = sizeof(_SpectralEnvFollower);
-    req.dram = 0;
+    req.dram = kDramLayout.total;
     req.dtc  = sizeof(_SpectralEnvFollower_DTC);
     req.itc  = 0;
 }
 
+// -----------------------------------------------------------------------------
+// FFT tables – window, twiddle tables, radix plans and the normalisation
+// factors that depend on the size.  Configuration time only; n must be in
+// kFftSizes and divisor in kWindowDivisors.
+// -----------------------------------------------------------------------------
+static void buildFftTables(_SpectralEnvFollower_DTC *d, int n, int divisor)
+{
+    const int len = n / divisor;
+    const int start = n - len;
+    d->fftSize = n;
+    d->numBins = n / 2 + 1;
+    d->windowLength = len;
+    d->windowDivisor = divisor;
+    d->hopSize = len / 4;
+
+    // Periodic Hann over the last L samples – sums to a constant at 75%
+    // overlap, so the same window serves analysis and overlap-add synthesis.
+    for (int i = 0; i < n; i++) {
+        d->window[i] = (i < start) ? 0.0f
+                     : 0.5f * (1.0f - cosf((2.0f * M_PI_F * (i - start)) / (float)len));
+        d->cosTable[i] = cosf((2.0f * M_PI_F * i) / (float)n);
+    }
+
+    // Reassignment windows: time ramp about the window centre and dh/dn
+    const float centre = (float)start + 0.5f * (float)len;
+    for (int i = 0; i < n; i++) {
+        d->windowRamp[i] = ((float)i - centre) * d->window[i];
+        d->windowDeriv[i] = (i < start) ? 0.0f
+                          : (M_PI_F / (float)len) * sinf((2.0f * M_PI_F * (i - start)) / (float)len);
+    }
+
+    // Zero padding leaves Σ Hann at L/2; by Parseval the power of the padded
+    // N-point spectrum is N·Σ Hann² = N·L·3/8
+    const float windowSum = 0.5f * (float)len;            // Σ Hann[n]
+    d->fftRmsNormalization = 1.0f / (sqrtf((float)n * (float)len) * kHannWindowRmsGain);
+    d->peakNormPositive = 2.0f / windowSum;
+    d->peakNormEdge = 1.0f / windowSum;
+    d->binRmsScale = sqrtf((float)n) * d->fftRmsNormalization * kSqrtTwo;
+
+    // Power-of-two sizes keep the selected engine; others need mixed radix
+    planFFT(d->fft, n);
+    d->fft.type = isPowerOfTwo(n) ? d->fftEngineRequested : kFftEngineMixedRadix;
+
+    // Polyphase prototype: root-raised-cosine with bins one FFT bin apart
+    // (t in units of N samples), Hann-tapered over kWolaTaps frames
+    const int taps = kWolaTaps * n;
+    const float beta = kWolaRolloff;
+    float protoSum = 0.0f;
+    for (int j = 0; j < taps; j++) {
+        float t = (float)(j - taps / 2) / (float)n;
+        float h;
+        if (j == taps / 2) {
+            h = 1.0f - beta + 4.0f * beta / M_PI_F;
+        } else if (fabsf(fabsf(4.0f * beta * t) - 1.0f) < 1e-6f) {
+            float a = M_PI_F / (4.0f * beta);
+            h = (beta / kSqrtTwo) * ((1.0f + 2.0f / M_PI_F) * sinf(a) + (1.0f - 2.0f / M_PI_F) * cosf(a));
+        } else {
+            float bt = 4.0f * beta * t;
+            h = (sinf(M_PI_F * t * (1.0f - beta)) + bt * cosf(M_PI_F * t * (1.0f + beta)))
+              / (M_PI_F * t * (1.0f - bt * bt));
+        }
+        h *= 0.5f * (1.0f - cosf((2.0f * M_PI_F * j) / (float)taps));
+        d->wolaWindow[j] = h;
+        protoSum += h;
+    }
+    for (int j = 0; j < taps; j++) {
+        d->wolaWindow[j] *= windowSum * (float)divisor / protoSum;
+    }
+    d->wolaNormalization = 2.0f / (float)n;               // 1 / Σ h
+
+    // Adaptive short frames: Hann over the newest N/8 samples, unpadded
+    const int shortLen = n / kAdaptiveDivisor;
+    d->shortLength = shortLen;
+    for (int i = 0; i < shortLen; i++) {
+        d->shortWindow[i] = 0.5f * (1.0f - cosf((2.0f * M_PI_F * i) / (float)shortLen));
+    }
+    d->shortRmsNormalization = 1.0f / ((float)shortLen * kHannWindowRmsGain);
+    d->shortPeakNorm = 4.0f / (float)shortLen;
+
+    // Sub-transform of the zero-padded path: size L, cos(2πi/L) = cos(2πiP/N).
+    // A full window lends it to the adaptive short frames.
+    const int subLen = (divisor > 1) ? len : shortLen;
+    for (int i = 0; i < subLen; i++) {
+        d->cosTableSub[i] = d->cosTable[i * (n / subLen)];
+    }
+    planFFT(d->subFft, subLen);
+    d->subFft.type = isPowerOfTwo(subLen) ? d->fftEngineRequested : kFftEngineMixedRadix;
+}
+
+// -----------------------------------------------------------------------------
+// Zero-padded forward FFT – only the last L = N/P inputs are non-zero, so with
+// s = N - L and k = P·m + r:
+//   X[P·m + r] = Σ_{j<L} (x[s+j]·e^(-2πi·r·(s+j)/N)) · e^(-2πi·m·j/L)
+// i.e. P transforms of size L of the modulated tail, saving log2(P) stages of
+// butterflies over the padding.  The head of data is never read.
+// -----------------------------------------------------------------------------
+static void zeroPaddedFFT(_SpectralEnvFollower_DTC *d, Complex *data)
+{
+    const int n = d->fftSize;
+    const int len = d->windowLength;
+    const int parts = d->windowDivisor;
+    if (parts <= 1) {
+        runFFT(d->fft, data, n);
+        return;
+    }
+
+    const int start = n - len;
+    const int quarter = n / 4;
+    for (int j = 0; j < len; j++) {
+        d->padInput[j] = data[start + j];
+    }
+
+    for (int r = 0; r < parts; r++) {
+        // Modulate: phase index r·(s+j) mod N, sin read a quarter period back
+        int t = (r * start) % n;
+        for (int j = 0; j < len; j++) {
+            int ts = t - quarter;
+            if (ts < 0) ts += n;
+            const Complex &x = d->padInput[j];
+            float c = d->cosTable[t];
+            float s = -d->cosTable[ts];          // -sin(2πt/N)
+            d->padSub[j] = Complex(x.real * c - x.imag * s, x.real * s + x.imag * c);
+            t += r;
+            if (t >= n) t -= n;
+        }
+        runFFT(d->subFft, d->padSub, len);
+        for (int m = 0; m < len; m++) {
+            data[m * parts + r] = d->padSub[m];
+        }
+    }
+}
+
 // -----------------------------------------------------------------------------
 // construct – create a new algorithm instance.
 // -----------------------------------------------------------------------------
@@ -280,52 +1522,1519 @@ static _NT_algorithm *construct(const _NT_algorithmMemoryPtrs &mem,
 {
     auto *dtc = new (mem.dtc) _SpectralEnvFollower_DTC();
     
+    memset(mem.dram, 0, kDramLayout.total);
+
+    // Bind the size-dependent buffers
+    dtc->inputBuffer = layoutAt<float>(mem.dram, kDramLayout.inputBuffer);
+    dtc->carrierBuffer = layoutAt<float>(mem.dram, kDramLayout.carrierBuffer);
+    dtc->fftOutput = layoutAt<Complex>(mem.dram, kDramLayout.fftOutput);
+    dtc->magnitude = layoutAt<float>(mem.dram, kDramLayout.magnitude);
+    dtc->cosTable = layoutAt<float>(mem.dram, kDramLayout.cosTable);
+    dtc->fftWork = layoutAt<Complex>(mem.dram, kDramLayout.fftWork);
+    dtc->window = layoutAt<float>(mem.dram, kDramLayout.window);
+    dtc->bandMask = layoutAt<float[kMaxNumBins]>(mem.dram, kDramLayout.bandMask);
+    dtc->synthBuffer = layoutAt<Complex>(mem.dram, kDramLayout.synthBuffer);
+    dtc->olaBuffer = layoutAt<float[kMaxFftSize]>(mem.dram, kDramLayout.olaBuffer);
+    dtc->olaOut = layoutAt<float[kMaxHopSize]>(mem.dram, kDramLayout.olaOut);
+    dtc->frozenMag = layoutAt<float>(mem.dram, kDramLayout.frozenMag);
+    dtc->freezeSpectrum = layoutAt<Complex>(mem.dram, kDramLayout.freezeSpectrum);
+    dtc->freezePhase = layoutAt<uint16_t>(mem.dram, kDramLayout.freezePhase);
+    dtc->noiseFloor = layoutAt<float>(mem.dram, kDramLayout.noiseFloor);
+    dtc->denoiseGain = layoutAt<float>(mem.dram, kDramLayout.denoiseGain);
+    dtc->gainScratch = layoutAt<float>(mem.dram, kDramLayout.gainScratch);
+    dtc->carrierSpectrum = layoutAt<Complex>(mem.dram, kDramLayout.carrierSpectrum);
+    dtc->vocoderGain = layoutAt<float>(mem.dram, kDramLayout.vocoderGain);
+    dtc->vocoderBinPos = layoutAt<float>(mem.dram, kDramLayout.vocoderBinPos);
+    dtc->pruneMask = layoutAt<uint32_t[kMaxFftSize / 64]>(mem.dram, kDramLayout.pruneMask);
+    dtc->cqKernel = layoutAt<CqKernelEntry>(mem.dram, kDramLayout.cqKernel);
+    dtc->cqKernelStart = layoutAt<uint16_t>(mem.dram, kDramLayout.cqKernelStart);
+    dtc->cqMagnitude = layoutAt<float>(mem.dram, kDramLayout.cqMagnitude);
+    dtc->cqPowerWeight = layoutAt<float>(mem.dram, kDramLayout.cqPowerWeight);
+    dtc->windowRamp = layoutAt<float>(mem.dram, kDramLayout.windowRamp);
+    dtc->windowDeriv = layoutAt<float>(mem.dram, kDramLayout.windowDeriv);
+    dtc->reassignBuffer = layoutAt<Complex>(mem.dram, kDramLayout.reassignBuffer);
+    dtc->reassignDeriv = layoutAt<Complex>(mem.dram, kDramLayout.reassignDeriv);
+    dtc->reassignFreq = layoutAt<float>(mem.dram, kDramLayout.reassignFreq);
+    dtc->reassignTime = layoutAt<float>(mem.dram, kDramLayout.reassignTime);
+    dtc->cosTableSub = layoutAt<float>(mem.dram, kDramLayout.cosTableSub);
+    dtc->padInput = layoutAt<Complex>(mem.dram, kDramLayout.padInput);
+    dtc->padSub = layoutAt<Complex>(mem.dram, kDramLayout.padSub);
+    dtc->wolaWindow = layoutAt<float>(mem.dram, kDramLayout.wolaWindow);
+    dtc->wolaBuffer = layoutAt<Complex>(mem.dram, kDramLayout.wolaBuffer);
+    dtc->shortWindow = layoutAt<float>(mem.dram, kDramLayout.shortWindow);
+    dtc->shortMagnitude = layoutAt<float>(mem.dram, kDramLayout.shortMagnitude);
+    dtc->holdQueue = layoutAt<HoldEntry[kHoldCapacity]>(mem.dram, kDramLayout.holdQueue);
+    dtc->scopeHistory = layoutAt<uint8_t[kScopeColumns]>(mem.dram, kDramLayout.scopeHistory);
+    dtc->traceRing = layoutAt<uint32_t>(mem.dram, kDramLayout.traceRing);
+    dtc->traceScratch = layoutAt<uint32_t>(mem.dram, kDramLayout.traceScratch);
+    dtc->traceTailParams = layoutAt<int16_t>(mem.dram, kDramLayout.traceTailParams);
+    
     // Initialize arrays manually since memset can't be used with non-trivial types
-    for (int i = 0; i < kFftSize; i++) {
+    for (int i = 0; i < kWolaTaps * kMaxFftSize; i++) {
         dtc->inputBuffer[i] = 0.0f;
-        dtc->tempBuffer[i] = 0.0f;
+        dtc->carrierBuffer[i] = 0.0f;
+    }
+    for (int i = 0; i < kMaxFftSize; i++) {
         dtc->fftOutput[i] = Complex(0, 0);
+        dtc->wolaBuffer[i] = Complex(0, 0);
     }
-    for (int i = 0; i < kFftSize/2; i++) {
+    dtc->polyphase = false;
+    dtc->adaptive = false;
+    for (int k = 0; k < kMaxFftSize / (2 * kAdaptiveDivisor); k++) {
+        dtc->shortMagnitude[k] = 0.0f;
+    }
+    for (int b = 0; b < 3; b++) {
+        dtc->shortPeakLo[b] = dtc->shortPeakHi[b] = 0;
+        dtc->shortBandLo[b] = dtc->shortBandHi[b] = 0;
+    }
+    for (int i = 0; i < kMaxFftSize/2; i++) {
         dtc->magnitude[i] = 0.0f;
     }
-    for (int i = 0; i < 3; i++) {
-        dtc->env[i] = 0.0f;
+
+    for (int k = 0; k < kMaxFftSize/2; k++) {
+        dtc->reassignFreq[k] = (float)k;
+        dtc->reassignTime[k] = 0.0f;
     }
-    
-    // Initialize frequency values to zero - will be set by parameterChanged() calls
-    for (int i = 0; i < 3; i++) {
-        dtc->potCentres[i] = 0.0f;
-        dtc->potCentreBins[i] = 0.0f;
+    dtc->reassign = false;
+    for (int b = 0; b < 3; b++) {
+        dtc->bandPeakHz[b] = 0.0f;
+        dtc->bandPeakTime[b] = 0.0f;
+    }
+
+    // Window, twiddles and FFT plan – rebuilt when the FFT size changes
+    dtc->fftEngineRequested = kFftEngineRadix2;
+    dtc->fft.work = dtc->fftWork;
+    dtc->fft.cosTable = dtc->cosTable;
+    dtc->subFft.work = dtc->fftWork;
+    dtc->subFft.cosTable = dtc->cosTableSub;
+    buildFftTables(dtc, kDefaultFftSize, 1);
+    dtc->historySize = kDefaultFftSize;
+    dtc->decimation = 1;                   // planned by parameterChanged()
+    dtc->decimationStages = 0;
+    for (int s = 0; s < kMaxDecimationStages; s++) {
+        for (int i = 0; i < 2 * kHalfbandTaps; i++) {
+            dtc->decimator[s].delay[i] = 0.0f;
+        }
+        dtc->decimator[s].pos = 0;
+        dtc->decimator[s].odd = false;
+    }
+
+    // Resynthesis state – masks are rebuilt by parameterChanged()
+    for (int b = 0; b < 3; b++) {
+        for (int k = 0; k < kMaxNumBins; k++) {
+            dtc->bandMask[b][k] = (b == 0) ? 1.0f : 0.0f;
+        }
+    }
+    for (int c = 0; c < kNumSynthChannels; c++) {
+        for (int i = 0; i < kMaxFftSize; i++) {
+            dtc->olaBuffer[c][i] = 0.0f;
+        }
+        for (int i = 0; i < kMaxHopSize; i++) {
+            dtc->olaOut[c][i] = 0.0f;
+        }
+    }
+    for (int i = 0; i < kMaxFftSize; i++) {
+        dtc->synthBuffer[i] = Complex(0, 0);
+        dtc->fftWork[i] = Complex(0, 0);
+    }
+    dtc->olaPos = 0;
+    dtc->hopPos = 0;
+    dtc->audioPathsActive = false;
+
+    for (int k = 0; k < kMaxNumBins; k++) {
+        dtc->frozenMag[k] = 0.0f;
+        dtc->freezeSpectrum[k] = Complex(0, 0);
+        dtc->freezePhase[k] = 0;
+    }
+    dtc->freezeSeed = 0x12345678u;
+    dtc->frozen = false;
+
+    for (int k = 0; k < kMaxNumBins; k++) {
+        dtc->noiseFloor[k] = kNoiseFloorMin;
+        dtc->denoiseGain[k] = 1.0f;
+        dtc->gainScratch[k] = 1.0f;
+    }
+    dtc->denoiseThreshold = 4.0f;     // 6 dB
+    dtc->denoiseMinGain = 0.0316f;    // -30 dB
+    dtc->noiseLearnCount = 0;
+
+    for (int k = 0; k < kMaxNumBins; k++) {
+        dtc->carrierSpectrum[k] = Complex(0, 0);
+        dtc->vocoderGain[k] = 0.0f;
+        dtc->vocoderBinPos[k] = 0.0f;
+    }
+    for (int b = 0; b < kMaxVocoderBands; b++) {
+        dtc->vocoderEnv[b] = 0.0f;
+    }
+    for (int b = 0; b <= kMaxVocoderBands; b++) {
+        dtc->vocoderBandStart[b] = 0;
+    }
+    dtc->numVocoderBands = 0;         // planned by parameterChanged()
+    dtc->vocoderBandsRequested = 0;
+    dtc->pruneBands = 0;              // planned by parameterChanged()
+    dtc->pruneWorthwhile = false;
+    dtc->pruneMode = kPruneOff;       // set by parameterChanged()
+    dtc->displayIdleSamples = 0;
+
+    for (int k = 0; k < kCqBins; k++) {
+        dtc->cqMagnitude[k] = 0.0f;
+        dtc->cqPowerWeight[k] = 0.0f;
+    }
+    for (int k = 0; k <= kCqBins; k++) {
+        dtc->cqKernelStart[k] = 0;
+    }
+    dtc->cqBinsPerOctave = (float)kCqBins / log2f(kCqMaxHz / kCqMinHz);
+    dtc->constantQ = false;
+    dtc->cqKernelValid = false;
+    dtc->cqBuildBin = 0;
+    dtc->cqBuildEntries = 0;
+    for (int b = 0; b < 3; b++) {
+        dtc->cqBandLo[b] = 0;
+        dtc->cqBandHi[b] = -1;
+        dtc->cqPeakLo[b] = 0;
+        dtc->cqPeakHi[b] = -1;
+    }
+    dtc->gateOnLevel = 0.5f;                // set by parameterChanged()
+    dtc->gateOffLevel = 0.4f;
+    dtc->gateMinOnSamples = 0;
+    dtc->gateMinOffSamples = 0;
+    dtc->sampleClock = 0;
+    for (int i = 0; i < 3; i++) {
+        dtc->gateEdgeTime[i] = 0;
+        dtc->gateState[i] = false;
+        dtc->gateBlockStart[i] = false;
+        dtc->gateEdgeCount[i] = 0;
+    }
+    dtc->onsetRatio = 2.0f;                 // set by parameterChanged()
+    dtc->triggerSamples = 240;
+    for (int i = 0; i < 3; i++) {
+        dtc->onsetLevel[i] = 0.0f;
+        dtc->triggerHead[i] = 0;
+        dtc->triggerCount[i] = 0;
+        dtc->triggerRemaining[i] = 0;
+    }
+    dtc->holdWindowSamples = 24000;         // set by parameterChanged()
+    dtc->holdBucketSamples = 1;
+    for (int i = 0; i < 3; i++) {
+        dtc->holdHead[i] = 0;
+        dtc->holdCount[i] = 0;
+    }
+    dtc->spectrumEnv = 0.0f;
+    dtc->loudestBand = 0;
+    dtc->balance = 0.0f;
+    for (int i = 0; i < 3; i++) {
+        dtc->bandShare[i] = 0.0f;
+    }
+    dtc->scopePos = 0;
+    dtc->scopeColumnSamples = 750;          // set by parameterChanged()
+    dtc->scopeSampleCount = 0;
+    for (int i = 0; i < 3; i++) {
+        dtc->scopePeak[i] = 0.0f;
+        for (int x = 0; x < kScopeColumns; x++) {
+            dtc->scopeHistory[i][x] = 0;
+        }
+    }
+    dtc->traceActive = false;
+    dtc->traceTailRate = 0;
+    dtc->traceTail = 0;
+    dtc->traceUsed = 0;
+    for (int i = 0; i < 3; i++) {
+        dtc->env[i] = 0.0f;
+        // Linear 0-10 V until parameterChanged() builds the curves
+        for (int j = 0; j <= kCurveSegments; j++) {
+            dtc->curveTable[i][j] = kReferenceVoltage * (float)j / (float)kCurveSegments;
+        }
+    }
+    
+    // Initialize frequency values to zero - will be set by parameterChanged() calls
+    for (int i = 0; i < 3; i++) {
+        dtc->potCentres[i] = 0.0f;
+        dtc->potCentreBins[i] = 0.0f;
+    }
+
+    // Initialize envelope follower coefficients - will be updated by parameterChanged()
+    // Default to 10ms attack, 100ms release at 60Hz update rate
+    // 10ms * 60Hz = 0.6 updates, 100ms * 60Hz = 6 updates
+    dtc->attackCoeff = 1.0f - expf(-1.0f / 0.6f);   // ~0.81 (fast attack)
+    dtc->releaseCoeff = 1.0f - expf(-1.0f / 6.0f);  // ~0.15 (moderate release)
+    dtc->attackCoeff2 = 1.0f - expf(-2.0f / 0.6f);
+    dtc->releaseCoeff2 = 1.0f - expf(-2.0f / 6.0f);
+    for (int i = 0; i < 3; i++) {
+        dtc->envStage[i] = 0.0f;
+        dtc->twoPole[i] = false;
+    }
+    dtc->attackMs = 10.0f;
+    dtc->releaseMs = 100.0f;
+    dtc->bandwidthOctaves = 0.333f;                 // default 1/3 octave
+
+    dtc->samplesAccumulated = 0;
+    dtc->samplesSinceLastFFT = 0;    // initialize FFT rate limiter
+    dtc->sampleRate = (NT_globals.sampleRate > 0) ? (float)NT_globals.sampleRate : 48000.0f;
+    dtc->yScale              = 1.0f;
+    dtc->displayInitialized  = false; // initialize per-instance display flag
+
+    auto *alg = new (mem.sram) _SpectralEnvFollower(dtc);
+    alg->parameters      = gParameters;
+    alg->parameterPages  = &gParameterPages;
+
+    return alg;
+}
+
+// -----------------------------------------------------------------------------
+// Utility – convert band envelope level → voltage through the output's
+// response curve (linear interpolation in its lookup table).
+// -----------------------------------------------------------------------------
+static inline float envToVolts(const _SpectralEnvFollower_DTC *d, int b, float env)
+{
+    // Clamp for safety.
+    if (env < 0.0f) env = 0.0f;
+    if (env > 1.0f) env = 1.0f;
+    float pos = env * (float)kCurveSegments;
+    int i = (int)pos;
+    if (i > kCurveSegments - 1) i = kCurveSegments - 1;
+    float frac = pos - (float)i;
+    const float *table = d->curveTable[b];
+    return table[i] + frac * (table[i + 1] - table[i]);
+}
+
+// Response curve table: Min..Max through the chosen shape, plus Offset.
+// Configuration time only.
+enum { kCurveLinear = 0, kCurveExp, kCurveLog, kCurveS };
+
+static void buildCurveTable(_SpectralEnvFollower_DTC *d, int b, int shape,
+                            float minVolts, float maxVolts, float offsetVolts)
+{
+    const float expSpan = expf(kCurveExpRate) - 1.0f;
+    for (int j = 0; j <= kCurveSegments; j++) {
+        float x = (float)j / (float)kCurveSegments;
+        float y = x;
+        if (shape == kCurveExp) {
+            y = (expf(kCurveExpRate * x) - 1.0f) / expSpan;           // slow start
+        } else if (shape == kCurveLog) {
+            y = logf(1.0f + expSpan * x) / kCurveExpRate;             // inverse of Exp
+        } else if (shape == kCurveS) {
+            y = x * x * (3.0f - 2.0f * x);                            // smoothstep
+        }
+        d->curveTable[b][j] = minVolts + (maxVolts - minVolts) * y + offsetVolts;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Gate outputs – per-band Schmitt trigger on the envelope, evaluated once per
+// analysis frame.  An edge needs the level past its threshold and the
+// current state held for its minimum time; offset is the frame's sample
+// position in the block, kept for sample-accurate output.
+// -----------------------------------------------------------------------------
+static void updateGates(_SpectralEnvFollower_DTC *d, uint32_t now, int offset)
+{
+    for (int b = 0; b < 3; b++) {
+        const bool state = d->gateState[b];
+        const uint32_t held = now - d->gateEdgeTime[b];
+        bool next = state;
+        if (!state) {
+            next = d->env[b] >= d->gateOnLevel && held >= d->gateMinOffSamples;
+        } else {
+            next = !(d->env[b] < d->gateOffLevel && held >= d->gateMinOnSamples);
+        }
+        if (next == state) continue;
+
+        d->gateState[b] = next;
+        d->gateEdgeTime[b] = now;
+        if (d->gateEdgeCount[b] < kMaxGateEdges) {
+            d->gateEdgePos[b][d->gateEdgeCount[b]++] = offset;
+        } else {
+            d->gateEdgeCount[b]--;      // full – drop the last pair, keep the state
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Max-hold – sliding-window maximum of the per-frame envelopes.  Each band's
+// deque keeps only frames that could still become the maximum: a new value
+// evicts every smaller one from the back, and frames older than the hold
+// window leave from the front.  O(1) amortised per frame.  Time is split into
+// buckets of holdBucketSamples, at most one entry each: a frame landing in
+// the back entry's bucket merges into it (larger value, newer time), so the
+// deque never outgrows kHoldCapacity at any frame rate and the hold runs at
+// most one bucket (< 1% of the window) long rather than dropping the peak.
+// -----------------------------------------------------------------------------
+static void updateMaxHold(_SpectralEnvFollower_DTC *d, uint32_t now)
+{
+    const int mask = kHoldCapacity - 1;
+    for (int b = 0; b < 3; b++) {
+        HoldEntry *q = d->holdQueue[b];
+        int head = d->holdHead[b];
+        int count = d->holdCount[b];
+        const float v = d->env[b];
+
+        while (count > 0 && now - q[head].time > d->holdWindowSamples) {
+            head = (head + 1) & mask;
+            count--;
+        }
+        while (count > 0 && q[(head + count - 1) & mask].value <= v) {
+            count--;
+        }
+        HoldEntry &back = q[(head + count - 1) & mask];
+        if (count > 0 && back.time / d->holdBucketSamples == now / d->holdBucketSamples) {
+            back.time = now;            // back.value > v: extend it instead
+        } else {
+            q[(head + count) & mask] = { v, now };
+            count++;
+        }
+
+        d->holdHead[b] = head;
+        d->holdCount[b] = count;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Derived outputs – from the band envelopes and, when the frame measured the
+// whole spectrum (spectrumLevel >= 0), its level on the same scale.  The
+// total energy is the larger of the spectrum and the band sum, so
+// overlapping bands cannot take more than all of it.
+// -----------------------------------------------------------------------------
+static void updateDerived(_SpectralEnvFollower_DTC *d, float spectrumLevel)
+{
+    float total = 0.0f;
+    int loudest = 0;
+    for (int b = 0; b < 3; b++) {
+        total += d->env[b] * d->env[b];
+        if (d->env[b] > d->env[loudest]) loudest = b;
+    }
+    if (spectrumLevel >= 0.0f) {
+        float coeff = (spectrumLevel > d->spectrumEnv) ? d->attackCoeff : d->releaseCoeff;
+        d->spectrumEnv += coeff * (spectrumLevel - d->spectrumEnv);
+        float spectrumEnergy = d->spectrumEnv * d->spectrumEnv;
+        if (spectrumEnergy > total) total = spectrumEnergy;
+    }
+
+    // Silence keeps the last reading
+    if (d->env[loudest] < kDerivedFloor) return;
+
+    d->loudestBand = loudest;
+    for (int b = 0; b < 3; b++) {
+        d->bandShare[b] = d->env[b] * d->env[b] / total;
+    }
+    float low = d->env[0] * d->env[0];
+    float high = d->env[2] * d->env[2];
+    d->balance = (low + high > kDerivedFloor * kDerivedFloor) ? (high - low) / (high + low) : 0.0f;
+}
+
+// Constant CV for a whole block, in add or replace mode
+static inline void fillOutput(float *buf, int numFrames, float v, bool add)
+{
+    if (add) {
+        for (int n = 0; n < numFrames; ++n) buf[n] += v;
+    } else {
+        for (int n = 0; n < numFrames; ++n) buf[n] = v;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Onset localisation – a frame only says that a band rose somewhere in its
+// window, and the rise is new since the last frame.  Scan the newest span
+// ring samples (the hop) in kOnsetScanBlock energy blocks and return the
+// start of the block with the largest energy step (0 = start of the span),
+// refined to the first sample from the block before it that reaches the
+// step block's mean power.  The block before the span is the baseline for
+// the first one when the ring holds it.  No clear step means the onset
+// predates the span, so it is placed at its start.  Only steps in blocks
+// starting before limit count – a band's onset cannot come after its
+// reassigned time.
+// -----------------------------------------------------------------------------
+static int locateOnset(const _SpectralEnvFollower_DTC *d, int startIdx, int span, int limit)
+{
+    const int history = d->historySize;
+    int blocks = (limit + kOnsetScanBlock - 1) / kOnsetScanBlock;
+    if (blocks > span / kOnsetScanBlock) blocks = span / kOnsetScanBlock;
+    const int first = (span + kOnsetScanBlock <= history) ? -1 : 0;
+
+    float prev = 0.0f;
+    float bestStep = 0.0f;
+    float bestPower = 0.0f;
+    int best = 0;
+    int circIdx = startIdx + history - span + first * kOnsetScanBlock;
+    for (int k = first; k < blocks; k++) {
+        float e = 0.0f;
+        for (int i = 0; i < kOnsetScanBlock; i++) {
+            if (circIdx >= history) circIdx -= history;
+            float x = d->inputBuffer[circIdx++];
+            e += x * x;
+        }
+        if (k > first && e > kOnsetScanRatio * prev && e - prev > bestStep) {
+            bestStep = e - prev;
+            bestPower = e / (float)kOnsetScanBlock;
+            best = k * kOnsetScanBlock;
+        }
+        prev = e;
+    }
+    if (bestStep <= 0.0f) return 0;
+
+    int pos = (best > 0) ? best - kOnsetScanBlock : 0;
+    circIdx = startIdx + history - span + pos;
+    for (; pos < best + kOnsetScanBlock; pos++) {
+        if (circIdx >= history) circIdx -= history;
+        float x = d->inputBuffer[circIdx++];
+        if (x * x >= bestPower) break;
+    }
+    return pos;
+}
+
+// -----------------------------------------------------------------------------
+// Trace recorder – a log of everything step() reads (the input, carrier and
+// freeze gate buses, block sizes) and every parameter change, so a session
+// can be replayed bit-exactly through step() offline.  Records are whole
+// words in a ring; the header word is tag(4) | length in words(14) | info(14)
+// and the oldest records are dropped to make room.
+//
+// Each recorded bus is coded losslessly: the float bit patterns are mapped
+// to order-preserving integers, predicted from the previous sample or two
+// (one bit per stream per block), zigzagged and Rice coded with one
+// parameter per stream per block (5 bits, sent first), after the first
+// sample (32 bits).  Quotients of kTraceRiceEscape or more are sent as the
+// escape followed by the raw 32-bit residual.
+// -----------------------------------------------------------------------------
+struct TraceBitWriter {
+    uint32_t *words;
+    int       pos;
+    uint64_t  acc;
+    int       bits;
+};
+
+static inline void traceWriteBits(TraceBitWriter &w, uint32_t value, int n)
+{
+    w.acc = (w.acc << n) | (uint64_t)value;
+    w.bits += n;
+    while (w.bits >= 32) {
+        w.bits -= 32;
+        w.words[w.pos++] = (uint32_t)(w.acc >> w.bits);
+    }
+}
+
+static inline uint32_t traceOrderedBits(float x)
+{
+    uint32_t b;
+    memcpy(&b, &x, sizeof(b));
+    return (b & 0x80000000u) ? ~b : (b | 0x80000000u);
+}
+
+static inline uint32_t traceZigzag(uint32_t cur, uint32_t predicted)
+{
+    int32_t delta = (int32_t)(cur - predicted);
+    return ((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31);
+}
+
+static void traceEncodeStream(TraceBitWriter &w, const float *x, int n)
+{
+    // Predictor (previous sample, or linear extrapolation once two are
+    // known) and Rice parameter from the smaller mean residual
+    uint64_t sum[2] = {0, 0};
+    uint32_t prev2 = traceOrderedBits(x[0]);
+    uint32_t prev = prev2;
+    for (int i = 1; i < n; i++) {
+        uint32_t cur = traceOrderedBits(x[i]);
+        sum[0] += traceZigzag(cur, prev);
+        sum[1] += traceZigzag(cur, (i > 1) ? 2u * prev - prev2 : prev);
+        prev2 = prev;
+        prev = cur;
+    }
+    const int order = (sum[1] < sum[0]) ? 1 : 0;
+    uint32_t mean = (uint32_t)(sum[order] / (uint64_t)(n > 1 ? n - 1 : 1));
+    int k = mean ? 31 - __builtin_clz(mean) : 0;
+
+    traceWriteBits(w, (uint32_t)k, 5);
+    traceWriteBits(w, (uint32_t)order, 1);
+    prev = prev2 = traceOrderedBits(x[0]);
+    traceWriteBits(w, prev, 32);
+    for (int i = 1; i < n; i++) {
+        uint32_t cur = traceOrderedBits(x[i]);
+        uint32_t z = traceZigzag(cur, (order && i > 1) ? 2u * prev - prev2 : prev);
+        uint32_t q = z >> k;
+        if (q < (uint32_t)kTraceRiceEscape) {
+            traceWriteBits(w, (1u << (q + 1)) - 2u, (int)q + 1);     // q ones, a zero
+            if (k) traceWriteBits(w, z & ((1u << k) - 1u), k);
+        } else {
+            traceWriteBits(w, (1u << kTraceRiceEscape) - 1u, kTraceRiceEscape);
+            traceWriteBits(w, z, 32);
+        }
+        prev2 = prev;
+        prev = cur;
+    }
+}
+
+// Append words to the ring, dropping the oldest records as needed
+static void traceAppend(_SpectralEnvFollower_DTC *d, const uint32_t *words, int count)
+{
+    while (d->traceUsed + count > kTraceWords) {
+        uint32_t header = d->traceRing[d->traceTail];
+        int length = (int)((header >> 14) & 0x3FFF);
+        uint32_t value = d->traceRing[(d->traceTail + 1) % kTraceWords];
+        if ((header >> 28) == kTraceTagParam) {
+            d->traceTailParams[header & 0x3FFF] = (int16_t)value;
+        } else if ((header >> 28) == kTraceTagRate) {
+            d->traceTailRate = value;
+        }
+        d->traceTail = (d->traceTail + length) % kTraceWords;
+        d->traceUsed -= length;
+    }
+    int head = (d->traceTail + d->traceUsed) % kTraceWords;
+    for (int i = 0; i < count; i++) {
+        d->traceRing[head] = words[i];
+        head = (head + 1) % kTraceWords;
+    }
+    d->traceUsed += count;
+}
+
+static inline uint32_t traceHeader(int tag, int length, int info)
+{
+    return ((uint32_t)tag << 28) | ((uint32_t)length << 14) | ((uint32_t)info & 0x3FFF);
+}
+
+// Empty the ring; the tail state becomes the current one
+static void traceClear(_SpectralEnvFollower_DTC *d, const int16_t *v)
+{
+    for (int p = 0; p < (int)ARRAY_SIZE(gParameters); p++) {
+        d->traceTailParams[p] = v[p];
+    }
+    d->traceTailRate = (uint32_t)d->sampleRate;
+    d->traceTail = 0;
+    d->traceUsed = 0;
+}
+
+static void traceStart(_SpectralEnvFollower_DTC *d, const int16_t *v)
+{
+    traceClear(d, v);
+    d->traceActive = true;
+}
+
+static void traceParameter(_SpectralEnvFollower_DTC *d, int p, int16_t value)
+{
+    uint32_t record[2] = { traceHeader(kTraceTagParam, 2, p), (uint32_t)(uint16_t)value };
+    traceAppend(d, record, 2);
+}
+
+static void traceRate(_SpectralEnvFollower_DTC *d, uint32_t sampleRate)
+{
+    uint32_t record[2] = { traceHeader(kTraceTagRate, 2, 0), sampleRate };
+    traceAppend(d, record, 2);
+}
+
+// One block: header, flags word, then the coded streams in input, carrier,
+// freeze gate order.  Flags: bits 0-2 mark the streams present, bits 3-5 the
+// decimator stages due to output next, bits 8-31 the samples since the last
+// analysis frame – the schedule phase, which a replay from a wrapped ring
+// cannot otherwise recover.
+static void traceBlock(_SpectralEnvFollower_DTC *d, const float *streams[3], int framesBy4)
+{
+    const int numFrames = framesBy4 * 4;
+    if (numFrames * 3 * 2 + 2 > kTraceScratchWords || framesBy4 > 0x3FFF) {
+        uint32_t gap = traceHeader(kTraceTagGap, 1, framesBy4 & 0x3FFF);
+        traceAppend(d, &gap, 1);
+        return;
+    }
+
+    TraceBitWriter w = { d->traceScratch, 2, 0, 0 };
+    uint32_t flags = 0;
+    for (int s = 0; s < 3; s++) {
+        if (!streams[s]) continue;
+        flags |= 1u << s;
+        traceEncodeStream(w, streams[s], numFrames);
+    }
+    if (w.bits > 0) traceWriteBits(w, 0, 32 - w.bits);      // pad to a word
+    for (int s = 0; s < d->decimationStages; s++) {
+        if (d->decimator[s].odd) flags |= 8u << s;
+    }
+    flags |= (uint32_t)d->samplesSinceLastFFT << 8;
+    d->traceScratch[0] = traceHeader(kTraceTagBlock, w.pos, framesBy4);
+    d->traceScratch[1] = flags;
+    traceAppend(d, d->traceScratch, w.pos);
+}
+
+// -----------------------------------------------------------------------------
+// Analysis schedule – input samples between frames: one hop while the audio
+// outputs are in use, otherwise one FFT length of input – D times the FFT
+// size when decimated, so every decimated sample is analysed once – but at
+// least kFftRateHz.  step() and the time constants
+// both use this.
+// -----------------------------------------------------------------------------
+static inline int analysisInterval(const _SpectralEnvFollower_DTC *d, float sampleRate)
+{
+    if (d->audioPathsActive) return d->hopSize;
+    int interval = (int)(sampleRate / (float)kFftRateHz);
+    int span = d->fftSize * d->decimation;
+    return (interval < span) ? interval : span;
+}
+
+// -----------------------------------------------------------------------------
+// Envelope coefficients – the followers run once per analysis frame, so
+// every time constant is converted at the real frame duration.  The two-pole
+// smoother cascades two identical one-poles (a double real pole, critically
+// damped) at half the time constant each, so it settles in about the same
+// time as the one-pole but without the corner at each frame.
+// -----------------------------------------------------------------------------
+static void updateEnvelopeCoeffs(_SpectralEnvFollower_DTC *d, float sampleRate)
+{
+    float framesPerSecond = sampleRate / (float)analysisInterval(d, sampleRate);
+
+    // Calculate coefficient: 1 - exp(-1 / (time_constant_in_updates))
+    // Time constant = time to reach ~63% of target
+    float attackUpdates = (d->attackMs / 1000.0f) * framesPerSecond;
+    float releaseUpdates = (d->releaseMs / 1000.0f) * framesPerSecond;
+    d->attackCoeff = 1.0f - expf(-1.0f / attackUpdates);
+    d->releaseCoeff = 1.0f - expf(-1.0f / releaseUpdates);
+    d->attackCoeff2 = 1.0f - expf(-2.0f / attackUpdates);
+    d->releaseCoeff2 = 1.0f - expf(-2.0f / releaseUpdates);
+
+    // Denoiser time constants follow the same frame rate
+    d->noiseRiseFactor = powf(10.0f, kNoiseFloorRiseDbPerSec / (10.0f * framesPerSecond));
+    d->noiseFallCoeff = 1.0f - expf(-1000.0f / (kNoiseFloorFallMs * framesPerSecond));
+    d->denoiseReleaseCoeff = 1.0f - expf(-1000.0f / (kDenoiseReleaseMs * framesPerSecond));
+}
+
+// -----------------------------------------------------------------------------
+// Crossover masks – complementary raised-cosine splits (in log frequency)
+// between adjacent band centres.  Built as a tree so that, for every bin,
+// mask A + mask B + mask C == 1 and the band outputs sum back to the input.
+// -----------------------------------------------------------------------------
+static void updateCrossoverMasks(_SpectralEnvFollower_DTC *d, float binHz)
+{
+    for (int b = 0; b < 3; b++) {
+        if (d->potCentres[b] <= 0.0f) return;   // not configured yet
+    }
+
+    // Sort band indices by centre frequency
+    int order[3] = {0, 1, 2};
+    for (int i = 0; i < 2; i++) {
+        for (int j = 0; j < 2 - i; j++) {
+            if (d->potCentres[order[j]] > d->potCentres[order[j + 1]]) {
+                int t = order[j]; order[j] = order[j + 1]; order[j + 1] = t;
+            }
+        }
+    }
+
+    // Crossover at the geometric mean of neighbouring centres; the slope
+    // follows the band bandwidth so narrow bands give steep splits.
+    float widthOct = d->bandwidthOctaves;
+    if (widthOct < kMinCrossoverOctaves) widthOct = kMinCrossoverOctaves;
+    float xoverHz[2];
+    for (int i = 0; i < 2; i++) {
+        xoverHz[i] = sqrtf(d->potCentres[order[i]] * d->potCentres[order[i + 1]]);
+    }
+
+    for (int k = 0; k < d->numBins; k++) {
+        float freq = (float)k * binHz;
+        float remaining = 1.0f;
+        for (int i = 0; i < 2; i++) {
+            // Low-pass share of this crossover: 1 below, 0 above, cosine between
+            float lowShare = 1.0f;
+            if (k > 0) {
+                float x = log2f(freq / xoverHz[i]) / widthOct + 0.5f;
+                if (x >= 1.0f) {
+                    lowShare = 0.0f;
+                } else if (x > 0.0f) {
+                    lowShare = 0.5f * (1.0f + cosf(M_PI_F * x));
+                }
+            }
+            d->bandMask[order[i]][k] = remaining * lowShare;
+            remaining -= d->bandMask[order[i]][k];
+        }
+        d->bandMask[order[2]][k] = remaining;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Band bin range – bins [lo, hi] of the half spectrum covered by band b.
+// Shared by the envelope followers and the pruned-FFT planner.
+// -----------------------------------------------------------------------------
+static inline void bandBinRange(const _SpectralEnvFollower_DTC *d, int b, float binHz, int &lo, int &hi)
+{
+    const int half = d->fftSize / 2;
+
+    // Convert centre freq (Hz) → bin
+    float centreBin = d->potCentreBins[b];
+    float centreFreq = d->potCentres[b];
+
+    // Calculate bandwidth in bins based on octaves
+    // bandwidth_hz = centre_freq * (2^octaves - 1)
+    float bandwidthHz = centreFreq * (powf(2.0f, d->bandwidthOctaves) - 1.0f);
+    float bandwidthBins = bandwidthHz / binHz;
+
+    // Calculate bin range
+    lo = (int)roundf(centreBin - bandwidthBins / 2.0f);
+    hi = (int)roundf(centreBin + bandwidthBins / 2.0f);
+    if (lo < 0) lo = 0;
+    if (hi >= half) hi = half-1;
+}
+
+// -----------------------------------------------------------------------------
+// Pruned-FFT plan – masks for the needed bands and the verdict.  Pruning =
+// Off never prunes; On prunes whenever the masks skip any butterfly; Auto
+// asks the (provisional) cost model.  Only the in-place radix-2 layout can
+// be pruned, so other sizes never are.
+// -----------------------------------------------------------------------------
+static void updatePrunePlan(_SpectralEnvFollower_DTC *d)
+{
+    const int n = d->fftSize;
+    d->pruneWorthwhile = false;
+    if (d->pruneMode == kPruneOff) return;
+    // Constant-Q reads every bin; reassignment needs the bins N-k to split;
+    // a short window already skips the padding with its own sub-transforms
+    if (!isPowerOfTwo(n) || d->constantQ || d->reassign || d->windowDivisor > 1) return;
+
+    int lo[3], hi[3];
+    int numRanges = 0;
+    for (int b = 0; b < 3; b++) {
+        if (!(d->pruneBands & (1 << b))) continue;
+        lo[numRanges] = d->bandLo[b];
+        hi[numRanges] = d->bandHi[b];
+        numRanges++;
+    }
+    // An empty plan would cost nothing and always win, freezing every band
+    if (numRanges == 0) return;
+    planPrunedFFT(d->pruneMask, n, lo, hi, numRanges);
+
+    // Cost model: fully used stages run as plain loops, the rest per butterfly
+    int stages = 0;
+    while ((2 << stages) <= n) stages++;
+    float prunedCost = 0.0f;
+    int usedTotal = 0;
+    for (int s = 0; s < stages; s++) {
+        int used = 0;
+        for (int w = 0; w < n / 64; w++) {
+            used += __builtin_popcount(d->pruneMask[s][w]);
+        }
+        usedTotal += used;
+        prunedCost += (used == n / 2) ? (float)used : (float)used * kPrunedSparseCost;
+    }
+    if (d->pruneMode == kPruneOn) {
+        d->pruneWorthwhile = usedTotal < n / 2 * stages;
+        return;
+    }
+    float fullCost = (float)(n / 2 * stages) *
+                     ((d->fft.type == kFftEngineStockham) ? kFullCostStockham : kFullCostRadix2);
+    d->pruneWorthwhile = prunedCost < kPruneMinSaving * fullCost;
+}
+
+// Everything derived from the band centres and bandwidth
+static void updateBandPlans(_SpectralEnvFollower_DTC *d, float binHz)
+{
+    // step() reads the cached ranges, keeping powf/roundf off the audio path
+    for (int b = 0; b < 3; b++) {
+        bandBinRange(d, b, binHz, d->bandLo[b], d->bandHi[b]);
+    }
+    updateCrossoverMasks(d, binHz);
+    updatePrunePlan(d);
+
+    // Adaptive short frames – the same bands on the N/8-point grid.  The RMS
+    // range always spans the short Hann's main lobe (±2 bins) so a steady
+    // sine reads the same in short and long frames.
+    const int stride = kAdaptiveDivisor;
+    const int shortHalf = d->shortLength / 2;
+    for (int b = 0; b < 3; b++) {
+        const int lo = d->bandLo[b];
+        const int hi = d->bandHi[b];
+        float centre = d->potCentreBins[b] / (float)stride;
+        int peakLo = (lo + stride / 2) / stride;
+        int peakHi = (hi + stride / 2) / stride;
+        int bandLo = (int)ceilf(centre - 2.0f);
+        int bandHi = (int)floorf(centre + 2.0f);
+        if (bandLo > peakLo) bandLo = peakLo;
+        if (bandHi < peakHi) bandHi = peakHi;
+        if (bandLo < 0) bandLo = 0;
+        if (peakHi > shortHalf - 1) peakHi = shortHalf - 1;
+        if (bandHi > shortHalf - 1) bandHi = shortHalf - 1;
+        if (peakLo > peakHi) peakLo = peakHi;
+        d->shortPeakLo[b] = peakLo;
+        d->shortPeakHi[b] = peakHi;
+        d->shortBandLo[b] = bandLo;
+        d->shortBandHi[b] = bandHi;
+    }
+
+    // Constant-Q bins inside each band – bandwidth taken geometrically
+    // around the centre, at least the nearest bin.  Where the frame limits
+    // the resolution (low bins overlap heavily) the RMS range is widened to
+    // the centre bin's ENBW, i.e. 1 / power weight bins, so the sum still
+    // sees the whole response.
+    const float perOct = d->cqBinsPerOctave;
+    for (int b = 0; b < 3; b++) {
+        if (d->potCentres[b] <= 0.0f) continue;
+        float centre = perOct * log2f(d->potCentres[b] / kCqMinHz);
+        float halfWidth = 0.5f * perOct * d->bandwidthOctaves;
+        float rmsHalfWidth = halfWidth;
+        int centreBin = (int)roundf(centre);
+        if (centreBin >= 0 && centreBin < kCqBins && d->cqPowerWeight[centreBin] > 0.0f) {
+            float enbwHalfWidth = 0.5f / d->cqPowerWeight[centreBin];
+            if (rmsHalfWidth < enbwHalfWidth) rmsHalfWidth = enbwHalfWidth;
+        }
+        for (int r = 0; r < 2; r++) {
+            float w = (r == 0) ? halfWidth : rmsHalfWidth;
+            int lo = (int)ceilf(centre - w);
+            int hi = (int)floorf(centre + w);
+            if (hi < lo) lo = hi = centreBin;
+            if (lo < 0) lo = 0;
+            if (hi > kCqBins - 1) hi = kCqBins - 1;
+            if (r == 0) {
+                d->cqPeakLo[b] = lo;
+                d->cqPeakHi[b] = hi;
+            } else {
+                d->cqBandLo[b] = lo;
+                d->cqBandHi[b] = hi;
+            }
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Resynthesis – one forward FFT (the analysis frame) feeds every routed audio
+// output.  Each channel is a half spectrum times an optional per-bin gain;
+// two real outputs share each complex IFFT.
+// -----------------------------------------------------------------------------
+struct SynthSource
+{
+    const Complex *spectrum;   // half spectrum, DC..Nyquist
+    const float   *gain;       // per-bin gain, or nullptr for unity
+};
+
+static void synthesiseOutputs(_SpectralEnvFollower_DTC *d, const SynthSource *sources, const bool *active)
+{
+    const int n = d->fftSize;
+    const int half = n / 2;
+    const int hop = d->hopSize;
+
+    int channels[kNumSynthChannels];
+    int numActive = 0;
+    for (int c = 0; c < kNumSynthChannels; c++) {
+        if (active[c]) channels[numActive++] = c;
+    }
+
+    for (int p = 0; p < numActive; p += 2)
+    {
+        const SynthSource &srcA = sources[channels[p]];
+        const SynthSource *srcB = (p + 1 < numActive) ? &sources[channels[p + 1]] : nullptr;
+
+        // Pack spectra: Z = A + iB, with A, B Hermitian
+        for (int k = 0; k <= half; k++) {
+            Complex a = srcA.spectrum[k];
+            if (srcA.gain) {
+                a.real *= srcA.gain[k];
+                a.imag *= srcA.gain[k];
+            }
+            Complex b(0, 0);
+            if (srcB) {
+                b = srcB->spectrum[k];
+                if (srcB->gain) {
+                    b.real *= srcB->gain[k];
+                    b.imag *= srcB->gain[k];
+                }
+            }
+            // A[k] + i·B[k]
+            d->synthBuffer[k] = Complex(a.real - b.imag, a.imag + b.real);
+            if (k > 0 && k < half) {
+                // conj(A[k]) + i·conj(B[k])
+                d->synthBuffer[n - k] = Complex(a.real + b.imag, b.real - a.imag);
+            }
+        }
+
+        inverseFFT(d->fft, d->synthBuffer, n);
+
+        // Synthesis window and overlap-add (zero before the last L samples)
+        float *olaA = d->olaBuffer[channels[p]];
+        float *olaB = srcB ? d->olaBuffer[channels[p + 1]] : nullptr;
+        for (int i = n - d->windowLength; i < n; i++) {
+            float w = d->window[i] * kOlaGain;
+            int pos = d->olaPos + i;
+            if (pos >= n) pos -= n;
+            olaA[pos] += d->synthBuffer[i].real * w;
+            if (olaB) olaB[pos] += d->synthBuffer[i].imag * w;
+        }
+    }
+
+    // The oldest hop is now complete – move it to the output FIFO
+    for (int c = 0; c < kNumSynthChannels; c++) {
+        for (int i = 0; i < hop; i++) {
+            int pos = d->olaPos + i;
+            if (pos >= n) pos -= n;
+            d->olaOut[c][i] = d->olaBuffer[c][pos];
+            d->olaBuffer[c][pos] = 0.0f;
+        }
+    }
+    d->olaPos += hop;
+    if (d->olaPos >= n) d->olaPos -= n;
+    d->hopPos = 0;
+}
+
+// -----------------------------------------------------------------------------
+// Spectral freeze – latch the current magnitudes, then rebuild a complex
+// spectrum each hop from table phases (no trig in the audio path).
+// -----------------------------------------------------------------------------
+static inline uint32_t nextRandom(uint32_t &seed)
+{
+    seed = seed * 1664525u + 1013904223u;
+    return seed;
+}
+
+static void latchFreeze(_SpectralEnvFollower_DTC *d)
+{
+    const int n = d->fftSize;
+    const int half = n / 2;
+    for (int k = 0; k <= half; k++) {
+        float re = d->fftOutput[k].real;
+        float im = d->fftOutput[k].imag;
+        d->frozenMag[k] = sqrtf(re * re + im * im);
+        d->freezePhase[k] = (uint16_t)(((nextRandom(d->freezeSeed) >> 16) * (uint32_t)n) >> 16);
+    }
+}
+
+static void updateFreezeSpectrum(_SpectralEnvFollower_DTC *d, bool advancePhase)
+{
+    const int n = d->fftSize;
+    const int half = n / 2;
+    const int quarter = n / 4;
+
+    for (int k = 0; k <= half; k++) {
+        int phase;
+        if (advancePhase) {
+            // Bin-centre frequency: k cycles per frame → k·hop table steps per hop
+            phase = (d->freezePhase[k] + k * d->hopSize) % n;
+        } else {
+            // Scale a 16-bit random value onto [0, n) – n need not be a power of two
+            phase = (int)(((nextRandom(d->freezeSeed) >> 16) * (uint32_t)n) >> 16);
+        }
+        d->freezePhase[k] = (uint16_t)phase;
+
+        float mag = d->frozenMag[k];
+        if (k == 0 || k == half) {
+            // DC and Nyquist must stay real
+            d->freezeSpectrum[k] = Complex(mag, 0);
+        } else {
+            // sin(θ) = cos(θ - π/2)
+            int sinPhase = phase - quarter;
+            if (sinPhase < 0) sinPhase += n;
+            d->freezeSpectrum[k] = Complex(mag * d->cosTable[phase],
+                                           mag * d->cosTable[sinPhase]);
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Spectral denoiser – track the per-bin noise power (slow rise, fast fall),
+// derive a soft gate gain, smooth it across neighbouring bins and over time.
+// Runs on the analysis spectrum, so the only extra cost is one inverse FFT.
+// -----------------------------------------------------------------------------
+static void updateDenoiseGain(_SpectralEnvFollower_DTC *d)
+{
+    const int half = d->fftSize / 2;
+
+    for (int k = 0; k <= half; k++) {
+        float re = d->fftOutput[k].real;
+        float im = d->fftOutput[k].imag;
+        float power = re * re + im * im;
+
+        // Noise floor follower – minima are trusted, rises are rate-limited
+        // in dB/s so sustained tones are not absorbed into the floor
+        float floor = d->noiseFloor[k];
+        if (d->noiseLearnCount < kNoiseLearnFrames) {
+            // Learning: running mean of the first frames, bias-matched
+            float n = (float)d->noiseLearnCount;
+            floor = (floor * n + power / kNoiseFloorBias) / (n + 1.0f);
+        } else if (power < floor) {
+            floor += d->noiseFallCoeff * (power - floor);
+        } else {
+            floor *= d->noiseRiseFactor;
+        }
+        if (floor < kNoiseFloorMin) floor = kNoiseFloorMin;
+        d->noiseFloor[k] = floor;
+
+        // Soft mask: power subtraction against threshold × (bias-corrected) floor
+        float threshold = d->denoiseThreshold * kNoiseFloorBias * floor;
+        float g = (power > threshold) ? sqrtf(1.0f - threshold / power) : 0.0f;
+        if (g < d->denoiseMinGain) g = d->denoiseMinGain;
+        d->gainScratch[k] = g;
+    }
+    if (d->noiseLearnCount < kNoiseLearnFrames) d->noiseLearnCount++;
+
+    // Frequency smoothing (1-2-1) then time smoothing (instant open, slow close)
+    for (int k = 0; k <= half; k++) {
+        float left = d->gainScratch[(k > 0) ? k - 1 : k + 1];
+        float right = d->gainScratch[(k < half) ? k + 1 : k - 1];
+        float g = 0.25f * left + 0.5f * d->gainScratch[k] + 0.25f * right;
+
+        float prev = d->denoiseGain[k];
+        d->denoiseGain[k] = (g > prev) ? g : prev + d->denoiseReleaseCoeff * (g - prev);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Channel vocoder – log-spaced filterbank over the FFT bins.  The plan (band
+// start bins and each bin's fractional band position) is rebuilt on parameter
+// change; per frame the modulator band RMS is smoothed and interpolated back
+// to a per-bin gain for the carrier spectrum.
+// -----------------------------------------------------------------------------
+static void updateVocoderBands(_SpectralEnvFollower_DTC *d, int numBands, float binHz)
+{
+    if (numBands < 1) numBands = 1;
+    if (numBands > kMaxVocoderBands) numBands = kMaxVocoderBands;
+
+    const int half = d->fftSize / 2;
+    float maxHz = kVocoderMaxHz;
+    if (maxHz > (float)half * binHz) maxHz = (float)half * binHz;
+    const float octaves = log2f(maxHz / kVocoderMinHz);
+    const float bandOctaves = octaves / (float)numBands;
+
+    // Band edges – the first band reaches down to DC, the last up to Nyquist
+    d->vocoderBandStart[0] = 0;
+    for (int b = 1; b < numBands; b++) {
+        float edgeHz = kVocoderMinHz * exp2f(bandOctaves * (float)b);
+        int bin = (int)roundf(edgeHz / binHz);
+        if (bin <= d->vocoderBandStart[b - 1]) bin = d->vocoderBandStart[b - 1] + 1;
+        if (bin > half) bin = half;
+        d->vocoderBandStart[b] = (uint16_t)bin;
+    }
+    d->vocoderBandStart[numBands] = (uint16_t)(half + 1);
+
+    // Fractional band position of each bin, measured between band centres
+    const float firstCentreOct = 0.5f * bandOctaves;
+    for (int k = 0; k <= half; k++) {
+        float pos = 0.0f;
+        if (k > 0) {
+            pos = (log2f((float)k * binHz / kVocoderMinHz) - firstCentreOct) / bandOctaves;
+        }
+        if (pos < 0.0f) pos = 0.0f;
+        if (pos > (float)(numBands - 1)) pos = (float)(numBands - 1);
+        d->vocoderBinPos[k] = pos;
+    }
+
+    for (int b = 0; b < kMaxVocoderBands; b++) {
+        d->vocoderEnv[b] = 0.0f;
+    }
+    d->numVocoderBands = numBands;
+}
+
+static void updateVocoderGain(_SpectralEnvFollower_DTC *d)
+{
+    const int numBands = d->numVocoderBands;
+    if (numBands <= 0) return;
+
+    // Per-bin RMS → sine-equivalent amplitude (same scaling as the band CVs)
+    const float binRmsScale = d->binRmsScale;
+
+    for (int b = 0; b < numBands; b++) {
+        int lo = d->vocoderBandStart[b];
+        int hi = d->vocoderBandStart[b + 1];
+        float powerSum = 0.0f;
+        for (int k = lo; k < hi; k++) {
+            float re = d->fftOutput[k].real;
+            float im = d->fftOutput[k].imag;
+            powerSum += re * re + im * im;
+        }
+        float level = (hi > lo) ? sqrtf(powerSum / (float)(hi - lo)) * binRmsScale : 0.0f;
+
+        // Same attack/release as the band followers
+        float coeff = (level > d->vocoderEnv[b]) ? d->attackCoeff : d->releaseCoeff;
+        d->vocoderEnv[b] += coeff * (level - d->vocoderEnv[b]);
+    }
+
+    for (int k = 0; k < d->numBins; k++) {
+        float pos = d->vocoderBinPos[k];
+        int b0 = (int)pos;
+        int b1 = (b0 + 1 < numBands) ? b0 + 1 : b0;
+        float frac = pos - (float)b0;
+        d->vocoderGain[k] = d->vocoderEnv[b0] + frac * (d->vocoderEnv[b1] - d->vocoderEnv[b0]);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Constant-Q analysis (Brown–Puckette) – each bin k is the inner product of
+// the Hann-windowed frame with a temporal kernel: a Hann of Q cycles at f_k
+// (capped at the frame length) times exp(iω_k n), normalised so a sine of
+// amplitude A reads A/2.  By Parseval that equals (1/N)·Σ X[j]·conj(K_k[j]),
+// and K_k (the kernel's FFT) is nearly all zeros – only the entries above
+// kCqKernelThreshold × its peak are kept.  Built once per configuration;
+// after a sample-rate switch step() builds it a few bins per block instead.
+// -----------------------------------------------------------------------------
+static void buildCqKernelBins(_SpectralEnvFollower_DTC *d, float sampleRate, int count)
+{
+    const int n = d->fftSize;
+    const float ratio = exp2f(1.0f / d->cqBinsPerOctave);
+    const float q = 1.0f / (ratio - 1.0f);
+    Complex *scratch = d->synthBuffer;     // free between resynthesis frames
+
+    int entries = d->cqBuildEntries;
+    const int end = (d->cqBuildBin + count < kCqBins) ? d->cqBuildBin + count : kCqBins;
+    for (int k = d->cqBuildBin; k < end; k++) {
+        d->cqKernelStart[k] = (uint16_t)entries;
+        d->cqPowerWeight[k] = 0.0f;
+
+        float freq = kCqMinHz * exp2f((float)k / d->cqBinsPerOctave);
+        if (freq >= 0.5f * sampleRate) continue;   // above Nyquist – bin stays empty
+
+        // Centred on the analysis window, which holds the last L samples
+        int len = (int)(q * sampleRate / freq);
+        if (len > d->windowLength) len = d->windowLength;
+        if (len < 4) len = 4;
+        const int offset = n - d->windowLength + (d->windowLength - len) / 2;
+
+        // Temporal kernel: bin window × complex exponential.  The analysis
+        // window is already in the spectrum, so the effective window (used
+        // for the normalisation and ENBW) is the product of the two.
+        for (int i = 0; i < n; i++) {
+            scratch[i] = Complex(0, 0);
+        }
+        float sum = 0.0f;
+        float sumSq = 0.0f;
+        for (int i = 0; i < len; i++) {
+            int pos = offset + i;
+            float g = 0.5f * (1.0f - cosf((2.0f * M_PI_F * ((float)i + 0.5f)) / (float)len));
+            float w = d->window[pos] * g;
+            float cycles = freq * (float)pos / sampleRate;
+            cycles -= floorf(cycles);
+            scratch[pos] = Complex(g * cosf(2.0f * M_PI_F * cycles), g * sinf(2.0f * M_PI_F * cycles));
+            sum += w;
+            sumSq += w * w;
+        }
+        if (sum <= 0.0f) continue;
+        for (int i = offset; i < offset + len; i++) {
+            scratch[i].real /= sum;
+            scratch[i].imag /= sum;
+        }
+
+        // Band RMS: weight each bin's power by its spacing over its ENBW
+        float enbwHz = sampleRate * sumSq / (sum * sum);
+        d->cqPowerWeight[k] = (freq / q) / enbwHz;
+
+        // Spectral kernel – keep the significant entries, conjugated and /N
+        runFFT(d->fft, scratch, n);
+        float peak = 0.0f;
+        for (int j = 0; j < n; j++) {
+            float m = scratch[j].real * scratch[j].real + scratch[j].imag * scratch[j].imag;
+            if (m > peak) peak = m;
+        }
+        const float threshold = peak * kCqKernelThreshold * kCqKernelThreshold;
+        for (int j = 0; j < n && entries < kMaxCqKernelEntries; j++) {
+            float m = scratch[j].real * scratch[j].real + scratch[j].imag * scratch[j].imag;
+            if (m >= threshold) {
+                d->cqKernel[entries].bin = (uint16_t)j;
+                d->cqKernel[entries].coeff = Complex(scratch[j].real / (float)n, -scratch[j].imag / (float)n);
+                entries++;
+            }
+        }
+    }
+    d->cqBuildBin = end;
+    d->cqBuildEntries = entries;
+    if (end == kCqBins) {
+        d->cqKernelStart[kCqBins] = (uint16_t)entries;
+        d->cqKernelValid = true;
+    }
+}
+
+static void restartCqKernel(_SpectralEnvFollower_DTC *d)
+{
+    d->cqKernelValid = false;
+    d->cqBuildBin = 0;
+    d->cqBuildEntries = 0;
+}
+
+static void buildCqKernel(_SpectralEnvFollower_DTC *d, float sampleRate)
+{
+    restartCqKernel(d);
+    buildCqKernelBins(d, sampleRate, kCqBins);
+}
+
+// Sparse kernel × spectrum → constant-Q magnitudes (needs the full spectrum)
+static void updateCqMagnitudes(_SpectralEnvFollower_DTC *d)
+{
+    for (int k = 0; k < kCqBins; k++) {
+        float re = 0.0f;
+        float im = 0.0f;
+        for (int e = d->cqKernelStart[k]; e < d->cqKernelStart[k + 1]; e++) {
+            const Complex &x = d->fftOutput[d->cqKernel[e].bin];
+            const Complex &c = d->cqKernel[e].coeff;
+            re += x.real * c.real - x.imag * c.imag;
+            im += x.real * c.imag + x.imag * c.real;
+        }
+        d->cqMagnitude[k] = sqrtf(re * re + im * im);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Reassignment – with X_h the analysis spectrum, X_th (time-ramped window) and
+// X_dh (derivative window), each bin's energy is reassigned to
+//   ω̂ = ω_k - Im(X_dh·conj(X_h)) / |X_h|²      (rad/sample)
+//   t̂ = Re(X_th·conj(X_h)) / |X_h|²             (samples from the window centre)
+// The two extra windows share one packed complex FFT.
+// -----------------------------------------------------------------------------
+static void updateReassignment(_SpectralEnvFollower_DTC *d)
+{
+    const int n = d->fftSize;
+    const int half = n / 2;
+    const float radToBins = (float)n / (2.0f * M_PI_F);
+
+    zeroPaddedFFT(d, d->reassignBuffer);
+    splitPackedSpectrum(d->reassignBuffer, d->reassignDeriv, n);
+
+    for (int k = 0; k < half; k++) {
+        const Complex &xh = d->fftOutput[k];
+        const Complex &xt = d->reassignBuffer[k];
+        const Complex &xd = d->reassignDeriv[k];
+        float power = xh.real * xh.real + xh.imag * xh.imag;
+        if (power < kNoiseFloorMin) {
+            d->reassignFreq[k] = (float)k;
+            d->reassignTime[k] = 0.0f;
+            continue;
+        }
+        // Im(xd·conj(xh)) and Re(xt·conj(xh))
+        float freqShift = (xd.imag * xh.real - xd.real * xh.imag) / power;
+        float timeShift = (xt.real * xh.real + xt.imag * xh.imag) / power;
+        d->reassignFreq[k] = (float)k - freqShift * radToBins;
+        d->reassignTime[k] = timeShift;
+    }
+}
+
+// Hann amplitude response at a frequency offset of delta bins (1 at 0).
+// sin(πa) = cos(2π·(1/4 - a/2)), read from the first quarter of the n-point
+// cosine table with linear interpolation so the audio path makes no libm call.
+static inline float hannResponse(const float* cosTable, int n, float delta)
+{
+    float a = fabsf(delta);
+    if (a < 1e-4f) return 1.0f;
+    if (a > 1.0f) a = 1.0f;                  // beyond the main-lobe half width
+    float den = 1.0f - a * a;
+    if (den < 1e-3f) return 0.5f;            // limit at one bin
+    float pos = (0.25f - 0.5f * a) * (float)n;   // 0..n/4
+    int i0 = (int)pos;
+    float frac = pos - (float)i0;
+    float s = cosTable[i0] + frac * (cosTable[i0 + 1] - cosTable[i0]);
+    return s / (M_PI_F * a * den);
+}
+
+// -----------------------------------------------------------------------------
+// Adaptive window – a frame whose newest N/8 samples carry a transient has its
+// bands measured by a short Hann transform of just those samples; steady
+// frames keep the full window.  The short spectrum is every 8th bin of the
+// zero-padded one, with its own normalisation so the CVs line up.
+// -----------------------------------------------------------------------------
+static bool detectTransient(const _SpectralEnvFollower_DTC *d, int startIdx)
+{
+    const int n = d->fftSize;
+    const int len = d->shortLength;
+    const int history = d->historySize;
+
+    // Mean power of the newest block against the rest of the frame
+    float older = 0.0f;
+    float newest = 0.0f;
+    int circIdx = startIdx + history - n;
+    for (int i = 0; i < n; i++) {
+        if (circIdx >= history) circIdx -= history;
+        float x = d->inputBuffer[circIdx++];
+        if (i < n - len) older += x * x;
+        else newest += x * x;
+    }
+    return newest > kTransientFloor * (float)len &&
+           newest * (float)(n - len) > kTransientRatio * older * (float)len;
+}
+
+// Short frame → shortMagnitude; fillDisplay also spreads it over the full
+// grid (scaled to full-window levels) when no long frame was transformed
+static void analyseShortFrame(_SpectralEnvFollower_DTC *d, int startIdx, bool fillDisplay)
+{
+    const int len = d->shortLength;
+    const int history = d->historySize;
+    int circIdx = startIdx + history - len;
+    for (int j = 0; j < len; j++) {
+        if (circIdx >= history) circIdx -= history;
+        d->padSub[j] = Complex(d->inputBuffer[circIdx++] * d->shortWindow[j], 0.0f);
+    }
+    runFFT(d->subFft, d->padSub, len);
+
+    const int shortHalf = len / 2;
+    for (int m = 0; m < shortHalf; m++) {
+        float re = d->padSub[m].real;
+        float im = d->padSub[m].imag;
+        d->shortMagnitude[m] = sqrtf(re * re + im * im);
+    }
+
+    if (fillDisplay) {
+        const int half = d->fftSize / 2;
+        for (int k = 0; k < half; k++) {
+            int m = (k + kAdaptiveDivisor / 2) / kAdaptiveDivisor;
+            if (m > shortHalf - 1) m = shortHalf - 1;
+            d->magnitude[k] = d->shortMagnitude[m] * (float)kAdaptiveDivisor;
+        }
+    }
+}
+
+// Bin spacing of the analysis – the ring holds the input decimated by D
+static inline float analysisBinHz(const _SpectralEnvFollower_DTC *d, float sampleRate)
+{
+    return sampleRate / (float)(d->decimation * d->fftSize);
+}
+
+// -----------------------------------------------------------------------------
+// Input decimation – when nothing needs the top of the spectrum (no audio
+// outputs or constant-Q analysis) the input is halved until the highest edge
+// of `bands` would leave the decimated passband.  The same FFT then spans a
+// D-times narrower range with D-times finer bins; the display shows that
+// range.  A change restarts the analysis history and rescales the envelope
+// time constants to the new frame interval.
+// -----------------------------------------------------------------------------
+static void updateDecimation(_SpectralEnvFollower_DTC *d, uint8_t bands, float sampleRate)
+{
+    int stages = 0;
+    if (!d->audioPathsActive && !d->constantQ && bands) {
+        float top = 0.0f;
+        for (int b = 0; b < 3; b++) {
+            if (!(bands & (1 << b))) continue;
+            // Upper edge as bandBinRange() measures it: centre + bandwidth / 2
+            float edge = d->potCentres[b] * (0.5f + 0.5f * exp2f(d->bandwidthOctaves));
+            if (edge > top) top = edge;
+        }
+        while (stages < kMaxDecimationStages &&
+               top <= kDecimationPassband * sampleRate / (float)(2 << stages)) {
+            stages++;
+        }
+    }
+    if (stages == d->decimationStages) return;
+
+    d->decimationStages = stages;
+    d->decimation = 1 << stages;
+    for (int s = 0; s < kMaxDecimationStages; s++) {
+        for (int i = 0; i < 2 * kHalfbandTaps; i++) {
+            d->decimator[s].delay[i] = 0.0f;
+        }
+        d->decimator[s].pos = 0;
+        d->decimator[s].odd = false;
+    }
+    for (int i = 0; i < d->historySize; i++) {
+        d->inputBuffer[i] = 0.0f;
+        d->carrierBuffer[i] = 0.0f;
+    }
+    d->samplesAccumulated = 0;
+    d->samplesSinceLastFFT = 0;
+
+    float binHz = analysisBinHz(d, sampleRate);
+    for (int b = 0; b < 3; b++) {
+        d->potCentreBins[b] = d->potCentres[b] / binHz;
+    }
+    updateBandPlans(d, binHz);
+    if (d->vocoderBandsRequested > 0) {
+        updateVocoderBands(d, d->vocoderBandsRequested, binHz);
+    }
+    updateEnvelopeCoeffs(d, sampleRate);
+}
+
+// -----------------------------------------------------------------------------
+// Analysis restart – clear analysis and resynthesis to silence and re-plan
+// everything indexed by bin.  `kernelBins` constant-Q kernel bins are built
+// here; step() finishes any that are left.
+// -----------------------------------------------------------------------------
+static void resetAnalysis(_SpectralEnvFollower_DTC *d, float sampleRate, int kernelBins)
+{
+    const int n = d->fftSize;
+    float binHz = analysisBinHz(d, sampleRate);
+
+    d->historySize = d->polyphase ? kWolaTaps * n : n;
+    for (int i = 0; i < d->historySize; i++) {
+        d->inputBuffer[i] = 0.0f;
+        d->carrierBuffer[i] = 0.0f;
+    }
+    for (int i = 0; i < n / 2; i++) {
+        d->magnitude[i] = 0.0f;
+    }
+    for (int c = 0; c < kNumSynthChannels; c++) {
+        for (int i = 0; i < n; i++) {
+            d->olaBuffer[c][i] = 0.0f;
+        }
+        for (int i = 0; i < d->hopSize; i++) {
+            d->olaOut[c][i] = 0.0f;
+        }
+    }
+    for (int k = 0; k < d->numBins; k++) {
+        d->frozenMag[k] = 0.0f;
+        d->noiseFloor[k] = kNoiseFloorMin;
+        d->denoiseGain[k] = 1.0f;
+        d->carrierSpectrum[k] = Complex(0, 0);
     }
+    d->samplesAccumulated = 0;
+    d->samplesSinceLastFFT = 0;
+    d->olaPos = 0;
+    d->hopPos = d->hopSize;        // silence until the first new frame
+    d->frozen = false;
+    d->noiseLearnCount = 0;
 
-    // Initialize envelope follower coefficients - will be updated by parameterChanged()
-    // Default to 10ms attack, 100ms release at 60Hz update rate
-    // 10ms * 60Hz = 0.6 updates, 100ms * 60Hz = 6 updates
-    dtc->attackCoeff = 1.0f - expf(-1.0f / 0.6f);   // ~0.81 (fast attack)
-    dtc->releaseCoeff = 1.0f - expf(-1.0f / 6.0f);  // ~0.15 (moderate release)
-    dtc->bandwidthOctaves = 0.333f;                 // default 1/3 octave
+    for (int b = 0; b < 3; b++) {
+        d->potCentreBins[b] = d->potCentres[b] / binHz;
+    }
+    restartCqKernel(d);
+    if (d->constantQ) {
+        buildCqKernelBins(d, sampleRate, kernelBins);
+    }
+    updateBandPlans(d, binHz);
+    if (d->vocoderBandsRequested > 0) {
+        updateVocoderBands(d, d->vocoderBandsRequested, binHz);
+    }
+    updateEnvelopeCoeffs(d, sampleRate);
+}
 
-    dtc->samplesAccumulated = 0;
-    dtc->samplesSinceLastFFT = 0;    // initialize FFT rate limiter
-    dtc->yScale              = 1.0f;
-    dtc->displayInitialized  = false; // initialize per-instance display flag
+// -----------------------------------------------------------------------------
+// FFT size / window length change – rebuild the tables, then restart the
+// analysis with a complete kernel.
+// -----------------------------------------------------------------------------
+static void configureFftSize(_SpectralEnvFollower_DTC *d, int n, int divisor, float sampleRate)
+{
+    buildFftTables(d, n, divisor);
+    resetAnalysis(d, sampleRate, kCqBins);
+}
 
-    auto *alg = new (mem.sram) _SpectralEnvFollower(dtc);
-    alg->parameters      = gParameters;
-    alg->parameterPages  = &gParameterPages;
+// -----------------------------------------------------------------------------
+// Needed bands – every output that reads a band envelope keeps that band's
+// bins in the pruned FFT and inside the decimated range.
+// -----------------------------------------------------------------------------
+static uint8_t neededBands(const _SpectralEnvFollower *self)
+{
+    uint8_t needed = 0;
+    for (int b = 0; b < 3; b++) {
+        if (self->v[kParamCvOut1 + b * 2] > 0 || self->v[kParamGateOut1 + b * 2] > 0 ||
+            self->v[kParamTrigOut1 + b * 2] > 0 || self->v[kParamHoldOut1 + b * 2] > 0) {
+            needed |= (uint8_t)(1 << b);
+        }
+    }
+    // Loudest band, shares and balance compare all three envelopes, and the
+    // scope view traces them
+    if (self->v[kParamLoudestOut] > 0 || self->v[kParamBalanceOut] > 0 ||
+        self->v[kParamDisplay] == 1 ||
+        self->v[kParamShareOut1] > 0 || self->v[kParamShareOut2] > 0 ||
+        self->v[kParamShareOut3] > 0) {
+        needed = 0x7;
+    }
+    return needed;
+}
 
-    return alg;
+// Bands that bound the decimation: the needed ones, and all three while the
+// spectrum view marks them
+static uint8_t decimationBands(const _SpectralEnvFollower *self)
+{
+    return (self->v[kParamDisplay] == 0) ? (uint8_t)0x7 : self->dtc->pruneBands;
 }
 
 // -----------------------------------------------------------------------------
-// Utility – convert band envelope level → voltage (0-10 V).
+// Timed parameters – the settings held in samples.  Plain arithmetic, so a
+// sample-rate switch in step() can re-derive them all.
 // -----------------------------------------------------------------------------
-static inline float envToVolts(float env)
+static void updateTimedParams(_SpectralEnvFollower *self, float sampleRate)
 {
-    // Clamp for safety.
-    if (env < 0.0f) env = 0.0f;
-    return env * kReferenceVoltage;
+    auto *d = self->dtc;
+    d->gateMinOnSamples = (uint32_t)((float)self->v[kParamGateMinOn] * sampleRate / 1000.0f);
+    d->gateMinOffSamples = (uint32_t)((float)self->v[kParamGateMinOff] * sampleRate / 1000.0f);
+
+    d->triggerSamples = (int)((float)self->v[kParamTriggerLength] * sampleRate / 1000.0f);
+    if (d->triggerSamples < 1) d->triggerSamples = 1;
+
+    d->holdWindowSamples = (uint32_t)((float)self->v[kParamHoldTime] * sampleRate / 1000.0f);
+    // Live entries span the window plus one bucket, in distinct buckets
+    d->holdBucketSamples = d->holdWindowSamples / (kHoldCapacity - 2) + 1;
+
+    d->scopeColumnSamples = (int)((float)self->v[kParamScopeTime] * sampleRate / (float)kScopeColumns);
+    if (d->scopeColumnSamples < 1) d->scopeColumnSamples = 1;
 }
 
 // -----------------------------------------------------------------------------
@@ -338,43 +3047,185 @@ static void parameterChanged(_NT_algorithm *base, int paramIndex)
 
     // Use actual sample rate if available, otherwise assume 48kHz
     float sampleRate = (NT_globals.sampleRate > 0) ? (float)NT_globals.sampleRate : 48000.0f;
-    float binHz = sampleRate / (float)kFftSize;
+    float binHz = analysisBinHz(d, sampleRate);
+
+    // Trace – log every change while recording (step() starts and stops it)
+    if (paramIndex != kParamTrace && d->traceActive) {
+        traceParameter(d, paramIndex, self->v[paramIndex]);
+    }
 
     // Handle frequency parameter changes
     if (paramIndex == kParamBandAFreq) {
         d->potCentres[0] = (float)self->v[kParamBandAFreq];
         d->potCentreBins[0] = d->potCentres[0] / binHz;
+        updateBandPlans(d, binHz);
     }
     else if (paramIndex == kParamBandBFreq) {
         d->potCentres[1] = (float)self->v[kParamBandBFreq];
         d->potCentreBins[1] = d->potCentres[1] / binHz;
+        updateBandPlans(d, binHz);
     }
     else if (paramIndex == kParamBandCFreq) {
         d->potCentres[2] = (float)self->v[kParamBandCFreq];
         d->potCentreBins[2] = d->potCentres[2] / binHz;
+        updateBandPlans(d, binHz);
     }
     else if (paramIndex == kParamBandwidth) {
         // Bandwidth parameter is in percent (10-200), convert to octaves
         // 33% = 1/3 octave, 100% = 1 octave, 200% = 2 octaves
         float percent = (float)self->v[kParamBandwidth];
         d->bandwidthOctaves = percent / 100.0f;
+        updateBandPlans(d, binHz);
     }
     else if (paramIndex == kParamAttackTime) {
         // Convert attack time (ms) to coefficient for exponential smoothing
-        // NOTE: Envelope is updated at FFT rate (kFftRateHz), not audio rate
-        float attackMs = (float)self->v[kParamAttackTime];
-        // Calculate coefficient: 1 - exp(-1 / (time_constant_in_updates))
-        // Time constant = time to reach ~63% of target
-        float attackUpdates = (attackMs / 1000.0f) * (float)kFftRateHz;
-        d->attackCoeff = 1.0f - expf(-1.0f / attackUpdates);
+        // NOTE: Envelope is updated at the analysis frame rate, not audio rate
+        d->attackMs = (float)self->v[kParamAttackTime];
+        updateEnvelopeCoeffs(d, sampleRate);
     }
     else if (paramIndex == kParamReleaseTime) {
         // Convert release time (ms) to coefficient
-        // NOTE: Envelope is updated at FFT rate (kFftRateHz), not audio rate
-        float releaseMs = (float)self->v[kParamReleaseTime];
-        float releaseUpdates = (releaseMs / 1000.0f) * (float)kFftRateHz;
-        d->releaseCoeff = 1.0f - expf(-1.0f / releaseUpdates);
+        // NOTE: Envelope is updated at the analysis frame rate, not audio rate
+        d->releaseMs = (float)self->v[kParamReleaseTime];
+        updateEnvelopeCoeffs(d, sampleRate);
+    }
+    else if (paramIndex == kParamDenoiseThreshold) {
+        // dB above the noise floor → power ratio
+        d->denoiseThreshold = powf(10.0f, (float)self->v[kParamDenoiseThreshold] / 10.0f);
+    }
+    else if (paramIndex == kParamDenoiseDepth) {
+        // Maximum attenuation in dB → amplitude gain
+        d->denoiseMinGain = powf(10.0f, -(float)self->v[kParamDenoiseDepth] / 20.0f);
+    }
+    else if (paramIndex == kParamFftEngine) {
+        int engine = self->v[kParamFftEngine];
+        d->fftEngineRequested = (engine == 2) ? kFftEngineMixedRadix
+                              : (engine == 1) ? kFftEngineStockham : kFftEngineRadix2;
+        // Only power-of-two sizes can run the radix-2 kernels
+        d->fft.type = isPowerOfTwo(d->fftSize) ? d->fftEngineRequested : kFftEngineMixedRadix;
+        int subLength = (d->windowDivisor > 1) ? d->windowLength : d->shortLength;
+        d->subFft.type = isPowerOfTwo(subLength) ? d->fftEngineRequested : kFftEngineMixedRadix;
+        updatePrunePlan(d);
+    }
+    else if (paramIndex == kParamPruning) {
+        d->pruneMode = self->v[kParamPruning];
+        updatePrunePlan(d);
+    }
+    else if (paramIndex == kParamFftSize) {
+        int index = self->v[kParamFftSize];
+        if (index < 0 || index >= kNumFftSizes) index = kDefaultFftSizeIndex;
+        if (kFftSizes[index] != d->fftSize) {
+            configureFftSize(d, kFftSizes[index], d->windowDivisor, sampleRate);
+        }
+    }
+    else if (paramIndex >= kParamBandACurve && paramIndex <= kParamBandCOffset) {
+        int b = (paramIndex - kParamBandACurve) / kCurveParamStride;
+        int p = kParamBandACurve + b * kCurveParamStride;
+        buildCurveTable(d, b, self->v[p],
+                        (float)self->v[p + 1] * 0.1f,     // Min (0.1 V steps)
+                        (float)self->v[p + 2] * 0.1f,     // Max
+                        (float)self->v[p + 3] * 0.1f);    // Offset
+    }
+    else if (paramIndex >= kParamBandASmooth && paramIndex <= kParamBandCSmooth) {
+        // Start the second stage from the current output – no jump
+        int b = paramIndex - kParamBandASmooth;
+        d->twoPole[b] = (self->v[paramIndex] == 1);
+        d->envStage[b] = d->env[b];
+    }
+    else if (paramIndex == kParamGateOn || paramIndex == kParamGateOff) {
+        // Off above On would never release – clamp it to On
+        d->gateOnLevel = (float)self->v[kParamGateOn] / 100.0f;
+        d->gateOffLevel = (float)self->v[kParamGateOff] / 100.0f;
+        if (d->gateOffLevel > d->gateOnLevel) d->gateOffLevel = d->gateOnLevel;
+    }
+    else if (paramIndex == kParamGateMinOn || paramIndex == kParamGateMinOff ||
+             paramIndex == kParamTriggerLength || paramIndex == kParamHoldTime ||
+             paramIndex == kParamScopeTime) {
+        updateTimedParams(self, sampleRate);
+    }
+    else if (paramIndex == kParamOnsetThreshold) {
+        // Frame-to-frame rise in dB → amplitude ratio
+        d->onsetRatio = powf(10.0f, (float)self->v[kParamOnsetThreshold] / 20.0f);
+    }
+    else if (paramIndex == kParamWindowLength) {
+        // The last entry is Adaptive: full window, short frames on transients
+        int index = self->v[kParamWindowLength];
+        if (index < 0 || index > kNumWindowLengths) index = 0;
+        d->adaptive = (index == kNumWindowLengths);
+        int divisor = d->adaptive ? 1 : kWindowDivisors[index];
+        if (divisor != d->windowDivisor) {
+            configureFftSize(d, d->fftSize, divisor, sampleRate);
+        }
+    }
+    else if (paramIndex == kParamAnalysis) {
+        d->constantQ = (self->v[kParamAnalysis] == 1);
+        if (d->constantQ && !d->cqKernelValid) {
+            buildCqKernel(d, sampleRate);
+        }
+
+        // Polyphase folds kWolaTaps frames – restart the input history
+        bool polyphase = (self->v[kParamAnalysis] == 2);
+        if (polyphase != d->polyphase) {
+            d->polyphase = polyphase;
+            d->historySize = polyphase ? kWolaTaps * d->fftSize : d->fftSize;
+            for (int i = 0; i < d->historySize; i++) {
+                d->inputBuffer[i] = 0.0f;
+                d->carrierBuffer[i] = 0.0f;
+            }
+            d->samplesAccumulated = 0;
+            d->samplesSinceLastFFT = 0;
+        }
+        updateBandPlans(d, binHz);
+    }
+    else if (paramIndex == kParamReassign) {
+        d->reassign = (self->v[kParamReassign] == 1);
+        updatePrunePlan(d);
+    }
+    else if (paramIndex == kParamVocoderBands) {
+        d->vocoderBandsRequested = self->v[kParamVocoderBands];
+        updateVocoderBands(d, d->vocoderBandsRequested, binHz);
+    }
+    else if (paramIndex == kParamBandAOut || paramIndex == kParamBandBOut || paramIndex == kParamBandCOut ||
+             paramIndex == kParamFreezeOut || paramIndex == kParamDenoiseOut || paramIndex == kParamVocoderOut) {
+        // Audio outputs switch the analysis to the overlap-add hop schedule
+        bool active = false;
+        for (int c = 0; c < kNumSynthChannels; c++) {
+            if (self->v[kSynthOutParam[c]] > 0) active = true;
+        }
+        d->audioPathsActive = active;
+        updateEnvelopeCoeffs(d, sampleRate);
+
+        // Re-learn the noise floor whenever the denoiser is (re)routed
+        if (paramIndex == kParamDenoiseOut) {
+            d->noiseLearnCount = 0;
+        }
+    }
+
+    // Bands nothing reads need no FFT bins of their own
+    const uint8_t needed = neededBands(self);
+    if (needed != d->pruneBands) {
+        d->pruneBands = needed;
+        updatePrunePlan(d);
     }
+
+    // Bands, routing and analysis mode all bound the usable decimation
+    updateDecimation(d, decimationBands(self), sampleRate);
+}
+
+// -----------------------------------------------------------------------------
+// Sample-rate switch – the API has no other callback for it, so step() runs
+// this.  The FFT tables do not depend on the rate and are kept; the analysis
+// restarts, the bin plans, envelope coefficients and timed parameters are
+// re-derived, and the constant-Q kernel is left for step() to rebuild a few
+// bins per block.  Nothing is written to the trace beyond the rate record.
+// -----------------------------------------------------------------------------
+static void sampleRateChanged(_SpectralEnvFollower *self, float sampleRate)
+{
+    auto *d = self->dtc;
+    d->sampleRate = sampleRate;
+    resetAnalysis(d, sampleRate, 0);
+    updateTimedParams(self, sampleRate);
+    updateDecimation(d, decimationBands(self), sampleRate);
 }
 
 // -----------------------------------------------------------------------------
@@ -390,11 +3241,46 @@ static void step(_NT_algorithm *base, float *bus, int framesBy4)
     auto *d = self->dtc;
     
     const int numFrames = framesBy4 * 4;
+
+    // A sample-rate switch invalidates everything derived from it
+    const float currentRate = (NT_globals.sampleRate > 0) ? (float)NT_globals.sampleRate : 48000.0f;
+    if (currentRate != d->sampleRate) {
+        if (d->traceActive) traceRate(d, (uint32_t)currentRate);
+        sampleRateChanged(self, currentRate);
+    }
+
+    // Constant-Q kernel left unfinished by a rate switch – a few bins per
+    // block, then re-plan the bands on the finished kernel
+    if (d->constantQ && !d->cqKernelValid) {
+        buildCqKernelBins(d, d->sampleRate, kCqBinsPerStep);
+        if (d->cqKernelValid) updateBandPlans(d, analysisBinHz(d, d->sampleRate));
+    }
     
     // Validate input parameter
     int inputBus = self->v[kParamInput];
     if (inputBus < 1 || inputBus > 28) return;
     const float *inBuf = bus + (inputBus - 1) * numFrames;
+
+    // Trace mode changes are applied here, so the ring is only ever written
+    // from step(): Record starts a fresh log, Export stops and keeps it for
+    // serialise(), Off stops and discards it
+    const int traceMode = self->v[kParamTrace];
+    if (traceMode == 1) {
+        if (!d->traceActive) traceStart(d, self->v);
+    } else {
+        d->traceActive = false;
+        if (traceMode == 0 && d->traceUsed > 0) traceClear(d, self->v);
+    }
+
+    // Trace the buses step() may read, before anything writes to them
+    if (d->traceActive) {
+        const float *streams[3] = { inBuf, nullptr, nullptr };
+        int carrierIn = self->v[kParamCarrierInput];
+        int freezeIn = self->v[kParamFreezeGate];
+        if (carrierIn >= 1 && carrierIn <= 28) streams[1] = bus + (carrierIn - 1) * numFrames;
+        if (freezeIn >= 1 && freezeIn <= 28) streams[2] = bus + (freezeIn - 1) * numFrames;
+        traceBlock(d, streams, framesBy4);
+    }
     
     // Get output bus pointers
     float *outBuf[3] = {nullptr, nullptr, nullptr};
@@ -411,82 +3297,289 @@ static void step(_NT_algorithm *base, float *bus, int framesBy4)
         }
     }
 
+    // Gate output bus pointers
+    float *gateBuf[3] = {nullptr, nullptr, nullptr};
+    bool gateModeAdd[3] = {false, false, false};
+    for (int b = 0; b < 3; b++) {
+        int paramIdx = kParamGateOut1 + b * 2;
+        int outputBus = self->v[paramIdx];
+        if (outputBus >= 1 && outputBus <= 28) {
+            gateBuf[b] = bus + (outputBus - 1) * numFrames;
+            gateModeAdd[b] = (bool)self->v[paramIdx + 1];
+        }
+        d->gateBlockStart[b] = d->gateState[b];
+        d->gateEdgeCount[b] = 0;
+    }
+
+    // Trigger output bus pointers
+    float *trigBuf[3] = {nullptr, nullptr, nullptr};
+    bool trigModeAdd[3] = {false, false, false};
+    for (int b = 0; b < 3; b++) {
+        int paramIdx = kParamTrigOut1 + b * 2;
+        int outputBus = self->v[paramIdx];
+        if (outputBus >= 1 && outputBus <= 28) {
+            trigBuf[b] = bus + (outputBus - 1) * numFrames;
+            trigModeAdd[b] = (bool)self->v[paramIdx + 1];
+        }
+    }
+
+    // Audio output bus pointers (one per resynthesis channel)
+    float *audioBuf[kNumSynthChannels] = {};
+    bool audioModeAdd[kNumSynthChannels] = {};
+    bool audioActive[kNumSynthChannels] = {};
+
+    if (d->audioPathsActive) {
+        for (int c = 0; c < kNumSynthChannels; c++) {
+            int paramIdx = kSynthOutParam[c];
+            int outputBus = self->v[paramIdx];
+            if (outputBus >= 1 && outputBus <= 28) {
+                audioBuf[c] = bus + (outputBus - 1) * numFrames;
+                audioModeAdd[c] = (bool)self->v[paramIdx + 1];
+                audioActive[c] = true;
+            }
+        }
+    }
+
+    // Carrier input – only transformed while the vocoder output is routed
+    const float *carrierBuf = nullptr;
+    int carrierBus = self->v[kParamCarrierInput];
+    if (audioActive[kSynthVocoder] && carrierBus >= 1 && carrierBus <= 28) {
+        carrierBuf = bus + (carrierBus - 1) * numFrames;
+    }
+
+    // Freeze gate input (optional)
+    const float *freezeBuf = nullptr;
+    int freezeBus = self->v[kParamFreezeGate];
+    if (freezeBus >= 1 && freezeBus <= 28) {
+        freezeBuf = bus + (freezeBus - 1) * numFrames;
+    } else {
+        d->frozen = false;
+    }
+
     // -----------------------------------------------------------------
     // Accumulate samples until we have fftSize, then run analysis.
     // -----------------------------------------------------------------
+    const int fftSize = d->fftSize;
+    const int historySize = d->historySize;
     int idx = d->samplesAccumulated;
-    if (idx < 0 || idx >= kFftSize) {
+    if (idx < 0 || idx >= historySize) {
         idx = 0;
         d->samplesAccumulated = 0;
     }
     
-    // Calculate FFT interval based on sample rate
-    float sampleRate = (NT_globals.sampleRate > 0) ? (float)NT_globals.sampleRate : 48000.0f;
-    int fftInterval = (int)(sampleRate / (float)kFftRateHz);  // samples between FFTs
+    // Samples between FFTs – audio outputs need a fixed 75% overlap
+    // instead of the CV-only analysis rate
+    const float sampleRate = d->sampleRate;
+    const int fftInterval = analysisInterval(d, sampleRate);
+
+    // Output pruning – only when nothing but the band CVs reads the spectrum:
+    // no audio outputs, no freeze latch and the display not being drawn
+    const int displayIdleLimit = (int)(sampleRate * kDisplayIdleMs / 1000.0f);
+    if (d->displayIdleSamples <= displayIdleLimit) d->displayIdleSamples += numFrames;
+    // Band shares are taken of the whole spectrum, so they also need it
+    bool shareRouted = false;
+    for (int b = 0; b < 3; b++) {
+        if (self->v[kParamShareOut1 + b * 2] > 0) shareRouted = true;
+    }
+    const bool pruned = d->pruneWorthwhile && !d->audioPathsActive && !freezeBuf && !shareRouted &&
+                        d->displayIdleSamples > displayIdleLimit;
+
+    // Onset scan span – the ring samples written since the last frame, in
+    // whole scan blocks, within the analysis window
+    const int decimation = d->decimation;
+    int onsetSpan = (fftInterval + decimation - 1) / decimation;
+    onsetSpan = (onsetSpan + kOnsetScanBlock - 1) / kOnsetScanBlock * kOnsetScanBlock;
+    if (onsetSpan > d->windowLength) onsetSpan = d->windowLength;
     
+    const int decimationStages = d->decimationStages;
     for (int n = 0; n < numFrames; ++n)
     {
-        // Always store samples in circular buffer
-        d->inputBuffer[idx] = inBuf[n];
-        idx = (idx + 1) % kFftSize;  // Circular buffer
+        // Always store samples in circular buffer – after decimation, every
+        // D-th input (the carrier is only routed with D = 1)
+        float x = inBuf[n];
+        bool ready = true;
+        for (int s = 0; s < decimationStages && ready; ++s) {
+            ready = halfbandPush(d->decimator[s], x, x);
+        }
+        if (ready) {
+            d->inputBuffer[idx] = x;
+            if (carrierBuf) d->carrierBuffer[idx] = carrierBuf[n];
+            idx = (idx + 1) % historySize;  // Circular buffer
+        }
         
         d->samplesSinceLastFFT++;
         
-        // Process FFT at the specified rate, but ensure first FFT runs once buffer is full
-        if (d->samplesSinceLastFFT >= fftInterval || d->samplesSinceLastFFT == kFftSize)
+        if (d->samplesSinceLastFFT >= fftInterval)
         {
-            // Copy circular buffer to linear temp buffer for FFT
-            int startIdx = idx;  // Current position in circular buffer
-            for (int i = 0; i < kFftSize; ++i) {
-                int circIdx = (startIdx + i) % kFftSize;
-                d->tempBuffer[i] = d->inputBuffer[circIdx];
+            // Fused loader: unroll the circular buffer(s) and window in one
+            // pass.  The carrier rides in the imaginary half of the same FFT.
+            // Reassignment windows are applied in the same pass.  Samples
+            // before the window are zero padding and are never written.
+            // Polyphase analysis replaces the Hann frame unless resynthesis
+            // needs it, in which case the folded frame gets its own FFT.
+            const bool polyphase = d->polyphase;
+            const bool wolaSeparate = polyphase && d->audioPathsActive;
+            int startIdx = idx;  // Oldest sample in the circular buffer
+            // Adaptive: transient frames measure the bands on a short frame;
+            // the long one is still transformed for the audio outputs
+            const bool shortFrame = d->adaptive && !d->constantQ && !polyphase &&
+                                    detectTransient(d, startIdx);
+            const bool longFrame = !shortFrame || d->audioPathsActive;
+            const bool reassign = d->reassign && !pruned && !d->constantQ && !polyphase && !shortFrame;
+            if (longFrame && (!polyphase || wolaSeparate)) {
+                int frameIdx = startIdx + historySize - fftSize;   // newest N samples
+                for (int i = fftSize - d->windowLength; i < fftSize; ++i) {
+                    int circIdx = (frameIdx + i) % historySize;
+                    float w = d->window[i];
+                    float x = d->inputBuffer[circIdx];
+                    float carrier = carrierBuf ? d->carrierBuffer[circIdx] * w : 0.0f;
+                    d->fftOutput[i] = Complex(x * w, carrier);
+                    if (reassign) {
+                        d->reassignBuffer[i] = Complex(x * d->windowRamp[i], x * d->windowDeriv[i]);
+                    }
+                }
             }
-            
-            // Apply Hann window to temp buffer
-            for (int i = 0; i < kFftSize; ++i)
-            {
-                float w = 0.5f * (1.0f - cosf((2.0f * M_PI_F * i) / (kFftSize - 1)));
-                d->tempBuffer[i] *= w;
+
+            // Polyphase fold: y[i] = Σ_m x[i + mN]·h[i + mN] over the
+            // kWolaTaps·N history, oldest frame first
+            Complex *wolaFrame = wolaSeparate ? d->wolaBuffer : d->fftOutput;
+            if (polyphase) {
+                for (int i = 0; i < fftSize; ++i) {
+                    int circIdx = startIdx + i;
+                    float acc = 0.0f;
+                    for (int m = 0; m < kWolaTaps; ++m) {
+                        if (circIdx >= historySize) circIdx -= historySize;
+                        acc += d->inputBuffer[circIdx] * d->wolaWindow[m * fftSize + i];
+                        circIdx += fftSize;
+                    }
+                    wolaFrame[i] = Complex(acc, 0.0f);
+                }
             }
             
-            // Perform table-free FFT (real input -> complex output)
-            realFFT(d->tempBuffer, d->fftOutput, kFftSize);
+            // Calculate bin resolution for bandwidth calculation
+            float binHz = analysisBinHz(d, sampleRate);
+            const int half = fftSize / 2;
 
-            // Calculate magnitudes from complex FFT output
-            const int half = kFftSize / 2;
-            for (int k = 0; k < half; ++k)
-            {
-                float re = d->fftOutput[k].real;
-                float im = d->fftOutput[k].imag;
-                d->magnitude[k] = sqrtf(re * re + im * im);
+            if (shortFrame) {
+                analyseShortFrame(d, startIdx, !longFrame);
             }
+            float spectrumPower = 0.0f;
 
-            // Calculate bin resolution for bandwidth calculation
-            float binHz = sampleRate / (float)kFftSize;
+            // Perform FFT (real input(s) -> complex output)
+            if (!longFrame) {
+                // Short frame only – bands and display come from it
+            } else if (pruned) {
+                // Only the needed bands' bins are valid afterwards
+                prunedFFT(d->fftOutput, d->cosTable, d->pruneMask, fftSize);
+                for (int b = 0; b < 3; ++b) {
+                    if (!(d->pruneBands & (1 << b))) continue;
+                    for (int k = d->bandLo[b]; k <= d->bandHi[b]; ++k) {
+                        float re = d->fftOutput[k].real;
+                        float im = d->fftOutput[k].imag;
+                        d->magnitude[k] = sqrtf(re * re + im * im);
+                    }
+                }
+            } else {
+                // The folded frame fills all N inputs – no zero padding
+                if (polyphase && !wolaSeparate) {
+                    runFFT(d->fft, d->fftOutput, fftSize);
+                } else {
+                    zeroPaddedFFT(d, d->fftOutput);
+                }
+                if (carrierBuf) {
+                    splitPackedSpectrum(d->fftOutput, d->carrierSpectrum, fftSize);
+                }
+                if (wolaSeparate) {
+                    runFFT(d->fft, d->wolaBuffer, fftSize);
+                }
+
+                // Calculate magnitudes from complex FFT output; the power
+                // sum feeds the derived outputs
+                for (int k = 0; k < half; ++k)
+                {
+                    float re = wolaFrame[k].real;
+                    float im = wolaFrame[k].imag;
+                    float power = re * re + im * im;
+                    spectrumPower += power;
+                    d->magnitude[k] = sqrtf(power);
+                }
+                // Mirrored like the band sums – every bin but DC counts twice
+                spectrumPower = 2.0f * spectrumPower - d->magnitude[0] * d->magnitude[0];
+
+                // Constant-Q: one sparse product over the same spectrum
+                if (d->constantQ && d->cqKernelValid) {
+                    updateCqMagnitudes(d);
+                }
+
+                if (reassign) {
+                    updateReassignment(d);
+                }
+            }
 
             // Get detection mode (0 = RMS, 1 = Peak)
             bool usePeakDetection = (self->v[kParamDetectionMode] == 1);
 
-            // Update envelopes for each band.
-            for (int b=0;b<3;++b)
-            {
-                // Convert centre freq (Hz) → bin
-                float centreBin = d->potCentreBins[b];
-                float centreFreq = d->potCentres[b];
+            // Freeze gate – latch the spectrum on the rising edge
+            if (freezeBuf) {
+                bool gateHigh = freezeBuf[n] > kGateThreshold;
+                if (gateHigh && !d->frozen) {
+                    latchFreeze(d);
+                }
+                d->frozen = gateHigh;
+            }
+
+            int onsetPos = -1;          // scanned on the first onset only (no reassignment)
 
-                // Calculate bandwidth in bins based on octaves
-                // bandwidth_hz = centre_freq * (2^octaves - 1)
-                float bandwidthHz = centreFreq * (powf(2.0f, d->bandwidthOctaves) - 1.0f);
-                float bandwidthBins = bandwidthHz / binHz;
+            // Update envelopes for each band (held while frozen).
+            for (int b = 0; b < 3 && !d->frozen; ++b)
+            {
+                // Pruned frames have no valid bins for unneeded bands
+                if (pruned && !(d->pruneBands & (1 << b))) continue;
 
-                // Calculate bin range
-                int lo = (int)roundf(centreBin - bandwidthBins / 2.0f);
-                int hi = (int)roundf(centreBin + bandwidthBins / 2.0f);
-                if (lo < 0) lo = 0;
-                if (hi >= half) hi = half-1;
+                // Constant-Q kernel still being rebuilt – hold the envelopes
+                if (d->constantQ && !d->cqKernelValid) continue;
 
                 float env = 0.0f;
-                if (hi >= lo) {
+                if (d->constantQ) {
+                    // Constant-Q bins read A/2 for a sine of amplitude A
+                    float peakMag = 0.0f;
+                    float powerSum = 0.0f;
+                    for (int k = d->cqPeakLo[b]; k <= d->cqPeakHi[b]; ++k) {
+                        if (d->cqMagnitude[k] > peakMag) peakMag = d->cqMagnitude[k];
+                    }
+                    for (int k = d->cqBandLo[b]; k <= d->cqBandHi[b]; ++k) {
+                        float mag = d->cqMagnitude[k];
+                        powerSum += mag * mag * d->cqPowerWeight[k];
+                    }
+                    env = usePeakDetection ? 2.0f * peakMag : 2.0f * sqrtf(powerSum);
+                }
+
+                if (shortFrame) {
+                    // Short Hann frame on the N/8-point grid
+                    float peakMag = 0.0f;
+                    int peakBin = d->shortPeakLo[b];
+                    float powerSum = 0.0f;
+                    for (int m = d->shortPeakLo[b]; m <= d->shortPeakHi[b]; ++m) {
+                        if (d->shortMagnitude[m] > peakMag) {
+                            peakMag = d->shortMagnitude[m];
+                            peakBin = m;
+                        }
+                    }
+                    for (int m = d->shortBandLo[b]; m <= d->shortBandHi[b]; ++m) {
+                        float mag = d->shortMagnitude[m];
+                        powerSum += mag * mag * ((m == 0) ? 1.0f : 2.0f);
+                    }
+                    d->bandPeakHz[b] = (float)(peakBin * kAdaptiveDivisor) * binHz;
+                    d->bandPeakTime[b] = 0.0f;
+                    float peakScale = (peakBin == 0) ? 0.5f * d->shortPeakNorm : d->shortPeakNorm;
+                    env = usePeakDetection ? peakMag * peakScale
+                                           : sqrtf(powerSum) * d->shortRmsNormalization * kSqrtTwo;
+                }
+
+                const int lo = d->bandLo[b];
+                const int hi = d->bandHi[b];
+
+                if (!d->constantQ && !shortFrame && hi >= lo) {
                     // Peak and RMS metrics aggregated over the band
                     float peakMag = 0.0f;
                     int peakBin = lo;
@@ -506,13 +3599,32 @@ static void step(_NT_algorithm *base, float *bus, int framesBy4)
                         powerSum += mag2 * weight;
                     }
 
-                    if (usePeakDetection) {
+                    // Peak location – sub-bin when reassignment is running
+                    float peakBinFrac = reassign ? d->reassignFreq[peakBin] : (float)peakBin;
+                    d->bandPeakHz[b] = peakBinFrac * binHz;
+                    d->bandPeakTime[b] = reassign ? d->reassignTime[peakBin] : 0.0f;
+
+                    if (usePeakDetection && d->polyphase) {
+                        // Power-complementary bins: a sine lands in at most
+                        // two, so the peak pair's power is the whole sine
+                        float neighbour = 0.0f;
+                        if (peakBin > lo) neighbour = d->magnitude[peakBin - 1];
+                        if (peakBin < hi && d->magnitude[peakBin + 1] > neighbour) neighbour = d->magnitude[peakBin + 1];
+                        float peakScale = (peakBin == 0) ? d->wolaNormalization : 2.0f * d->wolaNormalization;
+                        env = sqrtf(peakMag * peakMag + neighbour * neighbour) * peakScale;
+                    } else if (usePeakDetection) {
                         // Convert FFT magnitude back to linear peak amplitude
-                        float peakScale = (peakBin == 0 || peakBin == half) ? kPeakNormEdge : kPeakNormPositive;
+                        float peakScale = (peakBin == 0 || peakBin == half) ? d->peakNormEdge : d->peakNormPositive;
                         env = peakMag * peakScale;
+                        // Undo the window's scalloping loss at the true frequency
+                        // (main-lobe width scales with the zero padding)
+                        if (reassign) {
+                            env /= hannResponse(d->cosTable, d->fftSize, (peakBinFrac - (float)peakBin) / (float)d->windowDivisor);
+                        }
                     } else if (powerSum > 0.0f) {
                         // Convert band power to an RMS amplitude, scaled so full-scale sine → 1.0
-                        float rms = sqrtf(powerSum) * kFftRmsNormalization;
+                        float rmsNorm = d->polyphase ? d->wolaNormalization : d->fftRmsNormalization;
+                        float rms = sqrtf(powerSum) * rmsNorm;
                         env = rms * kSqrtTwo;
                     }
                 }
@@ -523,8 +3635,33 @@ static void step(_NT_algorithm *base, float *bus, int framesBy4)
                     env = 1.0f;
                 }
 
+                // Onset: the raw level jumped since the last frame.  The
+                // trigger fires one span (about one hop) after the located
+                // onset, so every hit keeps its position within the hop.
+                if (trigBuf[b] && env > kOnsetFloor && env > d->onsetLevel[b] * d->onsetRatio &&
+                    d->triggerCount[b] < kMaxPendingTriggers) {
+                    int pos;
+                    if (reassign) {
+                        // Scan up to the band's own energy centroid – a
+                        // louder step in another band after it is ignored
+                        float centroid = d->bandPeakTime[b] + (float)(onsetSpan - d->windowLength / 2);
+                        pos = (centroid > 0.0f) ? locateOnset(d, startIdx, onsetSpan, (int)centroid + 1) : 0;
+                    } else {
+                        if (onsetPos < 0) onsetPos = locateOnset(d, startIdx, onsetSpan, onsetSpan);
+                        pos = onsetPos;
+                    }
+                    int slot = (d->triggerHead[b] + d->triggerCount[b]++) % kMaxPendingTriggers;
+                    d->triggerDue[b][slot] = d->sampleClock + (uint32_t)(n + pos * decimation);
+                }
+                d->onsetLevel[b] = env;
+
                 // Apply exponential smoothing with separate attack and release
-                if (env > d->env[b]) {
+                if (d->twoPole[b]) {
+                    // Critically damped: both stages share the direction's coefficient
+                    float c = (env > d->env[b]) ? d->attackCoeff2 : d->releaseCoeff2;
+                    d->envStage[b] += c * (env - d->envStage[b]);
+                    d->env[b] += c * (d->envStage[b] - d->env[b]);
+                } else if (env > d->env[b]) {
                     // Attack: approaching higher value
                     d->env[b] += d->attackCoeff * (env - d->env[b]);
                 } else {
@@ -533,9 +3670,96 @@ static void step(_NT_algorithm *base, float *bus, int framesBy4)
                 }
             }
 
+            // Gates follow the (possibly held) envelopes
+            updateGates(d, d->sampleClock + (uint32_t)n, n);
+            updateMaxHold(d, d->sampleClock + (uint32_t)n);
+
+            // Whole-spectrum level on the band RMS scale, when the bands
+            // were measured on the full FFT grid
+            if (!d->frozen) {
+                float spectrumLevel = -1.0f;
+                if (longFrame && !pruned && !shortFrame && !d->constantQ) {
+                    float rmsNorm = polyphase ? d->wolaNormalization : d->fftRmsNormalization;
+                    spectrumLevel = sqrtf(spectrumPower) * rmsNorm * kSqrtTwo;
+                    if (spectrumLevel > 1.0f) spectrumLevel = 1.0f;
+                }
+                updateDerived(d, spectrumLevel);
+            }
+
+            // Audio outputs – inverse FFTs into overlap-add
+            if (d->audioPathsActive) {
+                SynthSource sources[kNumSynthChannels];
+                for (int b = 0; b < 3; ++b) {
+                    sources[kSynthBandA + b] = { d->fftOutput, d->bandMask[b] };
+                }
+
+                // Freeze output passes the live signal until the gate latches
+                sources[kSynthFreeze] = { d->fftOutput, nullptr };
+                if (d->frozen && audioActive[kSynthFreeze]) {
+                    updateFreezeSpectrum(d, self->v[kParamFreezePhase] == 1);
+                    sources[kSynthFreeze] = { d->freezeSpectrum, nullptr };
+                }
+
+                // Denoiser gain is only tracked while its output is routed
+                sources[kSynthDenoise] = { d->fftOutput, d->denoiseGain };
+                if (audioActive[kSynthDenoise]) {
+                    updateDenoiseGain(d);
+                }
+
+                // Vocoder – carrier spectrum shaped by the input's band envelope
+                sources[kSynthVocoder] = { d->carrierSpectrum, d->vocoderGain };
+                if (audioActive[kSynthVocoder]) {
+                    if (carrierBuf) {
+                        updateVocoderGain(d);
+                    } else {
+                        audioActive[kSynthVocoder] = false;   // no carrier – silence
+                    }
+                }
+
+                synthesiseOutputs(d, sources, audioActive);
+            }
+
             // Reset FFT timer
             d->samplesSinceLastFFT = 0;
         }
+
+        // Audio outputs (one frame of latency)
+        if (d->audioPathsActive) {
+            int hp = d->hopPos;
+            for (int c = 0; c < kNumSynthChannels; ++c) {
+                if (audioBuf[c] == nullptr) continue;
+                float s = (hp < d->hopSize) ? d->olaOut[c][hp] : 0.0f;
+                if (audioModeAdd[c]) {
+                    audioBuf[c][n] += s;
+                } else {
+                    audioBuf[c][n] = s;
+                }
+            }
+            if (hp < d->hopSize) d->hopPos = hp + 1;
+        }
+
+        // Trigger outputs – queued onsets start their pulse when due
+        for (int b = 0; b < 3; ++b) {
+            if (trigBuf[b] == nullptr) {
+                d->triggerCount[b] = 0;     // unrouted – nothing stays queued
+                continue;
+            }
+            if (d->triggerCount[b] > 0 && (int32_t)(d->sampleClock + (uint32_t)n - d->triggerDue[b][d->triggerHead[b]]) >= 0) {
+                d->triggerRemaining[b] = d->triggerSamples;
+                d->triggerHead[b] = (d->triggerHead[b] + 1) % kMaxPendingTriggers;
+                d->triggerCount[b]--;
+            }
+            float v = 0.0f;
+            if (d->triggerRemaining[b] > 0) {
+                d->triggerRemaining[b]--;
+                v = kGateHighVolts;
+            }
+            if (trigModeAdd[b]) {
+                trigBuf[b][n] += v;
+            } else {
+                trigBuf[b][n] = v;
+            }
+        }
     }
     d->samplesAccumulated = idx;
 
@@ -545,7 +3769,7 @@ static void step(_NT_algorithm *base, float *bus, int framesBy4)
     for (int b = 0; b < 3; ++b)
     {
         if (outBuf[b] != nullptr) {
-            float v = envToVolts(d->env[b]);
+            float v = envToVolts(d, b, d->env[b]);
             
             if (outModeAdd[b]) {
                 for (int n = 0; n < numFrames; ++n) {
@@ -558,6 +3782,125 @@ static void step(_NT_algorithm *base, float *bus, int framesBy4)
             }
         }
     }
+
+    // -----------------------------------------------------------------
+    // Max-hold outputs – the deque heads, through the band response curves
+    // -----------------------------------------------------------------
+    for (int b = 0; b < 3; ++b)
+    {
+        int outputBus = self->v[kParamHoldOut1 + b * 2];
+        if (outputBus < 1 || outputBus > 28) continue;
+        float *holdBuf = bus + (outputBus - 1) * numFrames;
+
+        float held = d->holdCount[b] ? d->holdQueue[b][d->holdHead[b]].value : 0.0f;
+        fillOutput(holdBuf, numFrames, envToVolts(d, b, held), self->v[kParamHoldOut1 + b * 2 + 1]);
+    }
+
+    // -----------------------------------------------------------------
+    // Derived outputs – loudest band (stepped), shares 0-10 V, balance ±5 V
+    // -----------------------------------------------------------------
+    float derived[5] = {
+        kLoudestStepVolts * (float)d->loudestBand,
+        kReferenceVoltage * d->bandShare[0],
+        kReferenceVoltage * d->bandShare[1],
+        kReferenceVoltage * d->bandShare[2],
+        0.5f * kReferenceVoltage * d->balance,
+    };
+    for (int i = 0; i < 5; ++i)
+    {
+        int paramIdx = kParamLoudestOut + i * 2;
+        int outputBus = self->v[paramIdx];
+        if (outputBus < 1 || outputBus > 28) continue;
+        fillOutput(bus + (outputBus - 1) * numFrames, numFrames, derived[i], self->v[paramIdx + 1]);
+    }
+
+    // -----------------------------------------------------------------
+    // Gate outputs – the final state for the whole block, or each edge at
+    // the sample where its frame was analysed.
+    // -----------------------------------------------------------------
+    const bool sampleEdges = (self->v[kParamGateEdges] == 1);
+    for (int b = 0; b < 3; ++b)
+    {
+        if (gateBuf[b] == nullptr) continue;
+        bool state = sampleEdges ? d->gateBlockStart[b] : d->gateState[b];
+        const int edges = sampleEdges ? d->gateEdgeCount[b] : 0;
+        int start = 0;
+        for (int e = 0; e <= edges; ++e) {
+            int end = (e < edges) ? d->gateEdgePos[b][e] : numFrames;
+            float v = state ? kGateHighVolts : 0.0f;
+            if (gateModeAdd[b]) {
+                for (int n = start; n < end; ++n) gateBuf[b][n] += v;
+            } else {
+                for (int n = start; n < end; ++n) gateBuf[b][n] = v;
+            }
+            state = !state;
+            start = end;
+        }
+    }
+
+    // -----------------------------------------------------------------
+    // Envelope scope – the band CVs decimated to one column per pixel
+    // -----------------------------------------------------------------
+    for (int b = 0; b < 3; ++b) {
+        float v = envToVolts(d, b, d->env[b]);
+        if (v > d->scopePeak[b]) d->scopePeak[b] = v;
+    }
+    d->scopeSampleCount += numFrames;
+    if (d->scopeSampleCount >= d->scopeColumnSamples) {
+        d->scopeSampleCount = 0;
+        for (int b = 0; b < 3; ++b) {
+            float level = d->scopePeak[b] / kReferenceVoltage;
+            if (level < 0.0f) level = 0.0f;
+            if (level > 1.0f) level = 1.0f;
+            d->scopeHistory[b][d->scopePos] = (uint8_t)(level * 255.0f + 0.5f);
+            d->scopePeak[b] = 0.0f;
+        }
+        d->scopePos = (d->scopePos + 1) % kScopeColumns;
+    }
+
+    d->sampleClock += (uint32_t)numFrames;
+}
+
+// -----------------------------------------------------------------------------
+// Envelope scope – scrolling band traces written straight into NT_screen
+// (256×64, 4 bits per pixel, left pixel in the high nibble).  Each column
+// joins the previous sample to the current one so fast edges stay
+// connected; overlapping traces keep the brighter colour.
+// -----------------------------------------------------------------------------
+static inline void scopePixel(int x, int y, uint8_t colour)
+{
+    uint8_t &byte = NT_screen[y * 128 + (x >> 1)];
+    if (x & 1) {
+        if ((byte & 0x0F) < colour) byte = (uint8_t)((byte & 0xF0) | colour);
+    } else {
+        if ((byte >> 4) < colour) byte = (uint8_t)((byte & 0x0F) | (colour << 4));
+    }
+}
+
+static void drawScope(const _SpectralEnvFollower_DTC *d)
+{
+    static const uint8_t colours[3] = {15, 10, 5};
+    const int height = 64;
+
+    // 5 V reference, dotted
+    for (int x = 0; x < kScopeColumns; x += 4) {
+        scopePixel(x, height / 2, 2);
+    }
+
+    for (int b = 0; b < 3; ++b) {
+        int prevY = -1;
+        for (int x = 0; x < kScopeColumns; ++x) {
+            int col = (d->scopePos + x) % kScopeColumns;    // oldest at the left
+            int y = (height - 1) - (d->scopeHistory[b][col] * (height - 1) + 127) / 255;
+            int y0 = (prevY < 0) ? y : prevY;
+            int lo = (y0 < y) ? y0 : y;
+            int hi = (y0 < y) ? y : y0;
+            for (int yy = lo; yy <= hi; ++yy) {
+                scopePixel(x, yy, colours[b]);
+            }
+            prevY = y;
+        }
+    }
 }
 
 // -----------------------------------------------------------------------------
@@ -576,12 +3919,22 @@ static bool draw(_NT_algorithm *base)
     if (!d) {
         return false;
     }
+
+    // Scope view – the spectrum is not needed, so pruning may stay on (the
+    // traced bands are all needed while it is selected)
+    if (self->v && self->v[kParamDisplay] == 1) {
+        drawScope(d);
+        return true;
+    }
+
+    // The display is live – step() must keep computing the full spectrum
+    d->displayIdleSamples = 0;
     
     // Initialize bin positions on first draw (per-instance)
     if (!d->displayInitialized) {
         // Use actual sample rate if available, otherwise assume 48kHz
         float sampleRate = (NT_globals.sampleRate > 0) ? (float)NT_globals.sampleRate : 48000.0f;
-        float binHz = sampleRate / (float)kFftSize;
+        float binHz = analysisBinHz(d, sampleRate);
         
         // Recalculate bin positions from current frequency values (set by parameterChanged)
         for (int i = 0; i < 3; i++) {
@@ -589,11 +3942,11 @@ static bool draw(_NT_algorithm *base)
                 d->potCentreBins[i] = d->potCentres[i] / binHz;
                 // Ensure bin positions are valid and clipped to reasonable bounds
                 if (d->potCentreBins[i] < 0.0f) d->potCentreBins[i] = 0.0f;
-                if (d->potCentreBins[i] >= (float)(kFftSize/2)) d->potCentreBins[i] = (float)(kFftSize/2 - 1);
+                if (d->potCentreBins[i] >= (float)(d->fftSize/2)) d->potCentreBins[i] = (float)(d->fftSize/2 - 1);
             }
         }
         // Initialize magnitude array with small values to provide initial display
-        for (int i = 0; i < kFftSize/2; i++) {
+        for (int i = 0; i < d->fftSize/2; i++) {
             d->magnitude[i] = 0.001f;  // Small non-zero value for initial display
         }
         
@@ -604,27 +3957,34 @@ static bool draw(_NT_algorithm *base)
     // Clamp to actual display dimensions (256x64 for distingNT)
     const int width = 256;   // distingNT OLED width
     const int height = 64;   // distingNT OLED height
-    const int half = kFftSize / 2;  // 256 bins
+    const int half = d->fftSize / 2;  // 128..1024 bins
 
-    // Get sample rate and bin resolution for pink noise calculation
+    // Get sample rate and pixel resolution for pink noise calculation –
+    // the display always spans DC..Nyquist whatever the FFT size
     float sampleRate = (NT_globals.sampleRate > 0) ? (float)NT_globals.sampleRate : 48000.0f;
-    float binHz = sampleRate / (float)kFftSize;
+    float pixelHz = 0.5f * sampleRate / (float)width;
+
+    // FFT magnitudes grow with the window length – keep the bar heights of
+    // the 512-point view.  Constant-Q bins read A/2; a 512-point Hann FFT bin
+    // reads A·128.  Polyphase bins always read like a full-length Hann.
+    const bool constantQ = d->constantQ && d->cqKernelValid;
+    const int windowLength = d->polyphase ? d->fftSize : d->windowLength;
+    const float magScale = constantQ ? 0.5f * (float)kDefaultFftSize
+                                     : (float)kDefaultFftSize / (float)windowLength;
 
     // Draw pink noise reference overlay first (as background)
     // Pink noise has 1/f power spectrum, drops 3dB per octave
     // Draw it in a darker color (3-4) so it doesn't overpower the actual spectrum
-    const int maxBin = (width < half) ? width : half;  // Prevent buffer overflow - maxBin <= 256
-    // Safety: maxBin must not exceed magnitude array size (kFftSize/2 = 256)
-    for (int x = 1; x < maxBin; ++x) {  // Start at 1 to avoid log(0)
-        int binIdx = x;
-        float freq = binIdx * binHz;
+    for (int x = 1; x < width; ++x) {  // Start at 1 to avoid log(0)
+        float freq = x * pixelHz;
 
         // Pink noise magnitude is proportional to 1/sqrt(f)
         // Reference: at 1kHz, use a reasonable magnitude
         const float refFreq = 1000.0f;
         const float refMag = 200.0f;  // Tunable reference magnitude (increased for visibility)
 
-        float pinkMag = refMag * sqrtf(refFreq / freq);
+        // (equal power per bin – flat – on the constant-Q axis)
+        float pinkMag = constantQ ? refMag : refMag * sqrtf(refFreq / freq);
 
         // Apply same logarithmic scaling as main spectrum
         float logMag = (pinkMag > 0.001f) ? logf(pinkMag + 1.0f) : 0.0f;
@@ -650,13 +4010,26 @@ static bool draw(_NT_algorithm *base)
     // Always draw a baseline at the bottom to verify drawing is working
     NT_drawShapeI(kNT_line, 0, height-1, width-1, height-1, 15);
 
-    // Draw consecutive bins - 512 FFT gives us 256 bins, map directly to 256 pixels
-    for (int x = 0; x < maxBin; ++x) {
-        // Map display pixel directly to FFT bin (1:1 mapping)
-        int binIdx = x;
+    // Draw consecutive bins – N/2 bins spread over 256 pixels (1:1 at 512).
+    // Decimated analysis covers DC..Nyquist/D; pixels above it stay empty.
+    const int decimation = constantQ ? 1 : d->decimation;
+    for (int x = 0; x < width; ++x) {
+        // Bins covered by this pixel; the loudest one is drawn
+        int lo = x * half * decimation / width;
+        int hi = (x + 1) * half * decimation / width;
+        if (lo >= half) break;
+        if (hi <= lo) hi = lo + 1;
+        if (hi > half) hi = half;
 
-        // Get magnitude for this bin directly (binIdx guaranteed < half by loop condition)
-        float mag = d->magnitude[binIdx];
+        float mag = 0.0f;
+        if (constantQ) {
+            mag = d->cqMagnitude[x];   // one constant-Q bin per pixel
+        } else {
+            for (int k = lo; k < hi; ++k) {
+                if (d->magnitude[k] > mag) mag = d->magnitude[k];
+            }
+        }
+        mag *= magScale;
         
         // Apply logarithmic scaling for better visualization
         float logMag = (mag > 0.001f) ? logf(mag + 1.0f) : 0.0f;
@@ -683,10 +4056,15 @@ static bool draw(_NT_algorithm *base)
     for (int b = 0; b < 3; ++b) {
         // Use pre-calculated bin positions (updated by parameterChanged)
         float centerBin = d->potCentreBins[b];
+        float centerPixel = centerBin * (float)width / (float)(half * decimation);
+        if (constantQ) {
+            centerPixel = (d->potCentres[b] > 0.0f)
+                        ? d->cqBinsPerOctave * log2f(d->potCentres[b] / kCqMinHz) : 0.0f;
+        }
 
-        // Ensure centerBin is within display range
-        if (centerBin >= 1.0f && centerBin < (float)(width - 1)) {
-            int centerX = (int)roundf(centerBin);
+        // Ensure the marker is within display range
+        if (centerPixel >= 1.0f && centerPixel < (float)(width - 1)) {
+            int centerX = (int)roundf(centerPixel);
 
             // Strict bounds checking - ensure within screen bounds [0, width) x [0, height)
             if (centerX >= 0 && centerX < width) {
@@ -713,6 +4091,16 @@ static bool draw(_NT_algorithm *base)
         }
     }
 
+    // Reassigned band peaks – short ticks at the sub-bin peak frequency
+    if (d->reassign && !constantQ) {
+        for (int b = 0; b < 3; ++b) {
+            int peakX = (int)roundf(d->bandPeakHz[b] / pixelHz);
+            if (peakX >= 0 && peakX < width) {
+                NT_drawShapeI(kNT_line, peakX, 3, peakX, 6, 15);
+            }
+        }
+    }
+
     return true;  // Suppress header to use full screen
 }
 
@@ -800,6 +4188,51 @@ static void setupUi(_NT_algorithm *base, _NT_float3 &pots)
     }
 }
 
+// -----------------------------------------------------------------------------
+// serialise / deserialise – with Trace set to Export the stopped log travels
+// in the preset JSON: the sample rate and parameter snapshot at its oldest
+// record, then the record words oldest first.  step() no longer writes the
+// ring once recording has stopped, so this only reads it.  It is
+// export-only, so loading skips it.
+// -----------------------------------------------------------------------------
+static void serialise(_NT_algorithm *base, _NT_jsonStream &stream)
+{
+    auto *self = (_SpectralEnvFollower *)base;
+    if (!self || !self->dtc) return;
+    auto *d = self->dtc;
+    if (!self->v || self->v[kParamTrace] != 2 || d->traceActive || d->traceUsed == 0) return;
+
+    stream.addMemberName("trace");
+    stream.openObject();
+    stream.addMemberName("version");
+    stream.addNumber(2);
+    stream.addMemberName("sampleRate");
+    stream.addNumber((int)d->traceTailRate);
+    stream.addMemberName("params");
+    stream.openArray();
+    for (int p = 0; p < (int)ARRAY_SIZE(gParameters); p++) {
+        stream.addNumber((int)d->traceTailParams[p]);
+    }
+    stream.closeArray();
+    stream.addMemberName("words");
+    stream.openArray();
+    for (int i = 0; i < d->traceUsed; i++) {
+        stream.addNumber((int)d->traceRing[(d->traceTail + i) % kTraceWords]);
+    }
+    stream.closeArray();
+    stream.closeObject();
+}
+
+static bool deserialise(_NT_algorithm *, _NT_jsonParse &parse)
+{
+    int numMembers;
+    if (!parse.numberOfObjectMembers(numMembers)) return false;
+    for (int i = 0; i < numMembers; i++) {
+        if (!parse.skipMember()) return false;
+    }
+    return true;
+}
+
 // -----------------------------------------------------------------------------
 // Factory descriptor.
 // -----------------------------------------------------------------------------
@@ -823,8 +4256,8 @@ static const _NT_factory gFactory =
     .hasCustomUi                = hasCustomUi,
     .customUi                   = customUi,
     .setupUi                    = setupUi,
-    .serialise                  = nullptr,
-    .deserialise                = nullptr,
+    .serialise                  = serialise,
+    .deserialise                = deserialise,
     .midiSysEx                  = nullptr,
     .parameterUiPrefix          = nullptr,
     .parameterString            = nullptr,
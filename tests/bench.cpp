@@ -0,0 +1,109 @@
+// -----------------------------------------------------------------------------
+// FFT engine benchmark – µs per full-length transform for every size and
+// engine, on the plugin's own buffers.  Host timings only; build with the
+// module's flags (make bench) to compare like for like.
+// -----------------------------------------------------------------------------
+#include "host.h"
+#include <algorithm>
+
+static const char *const kEngineNames[] = { "Radix-2", "Stockham", "Mixed-Radix" };
+
+// Median of several timed runs of `iterations` transforms
+template <typename Fn>
+static double timeTransform(Fn fn, int iterations)
+{
+    double runs[7];
+    for (double &r : runs) {
+        double t0 = hostSeconds();
+        for (int i = 0; i < iterations; i++) fn();
+        r = (hostSeconds() - t0) * 1e6 / iterations;
+    }
+    std::sort(runs, runs + 7);
+    return runs[3];
+}
+
+static void benchEngines(Host &host)
+{
+    auto *d = host.state();
+    printf("%-6s %-12s %10s\n", "size", "engine", "us/fft");
+    for (int si = 0; si < kNumFftSizes; si++) {
+        host.set(kParamFftSize, si);
+        const int n = d->fftSize;
+        for (int e = 0; e < 3; e++) {
+            host.set(kParamFftEngine, e);
+            // Non-power-of-two sizes always run mixed radix
+            if (!isPowerOfTwo(n) && e != 2) continue;
+            // Each transform starts from the same frame (the copy is timed too)
+            std::vector<Complex> frame(n);
+            srand(1);
+            for (int i = 0; i < n; i++) {
+                frame[i] = Complex(rand() / (float)RAND_MAX - 0.5f, 0.0f);
+            }
+            double us = timeTransform([&]() {
+                memcpy(d->fftOutput, frame.data(), sizeof(Complex) * n);
+                runFFT(d->fft, d->fftOutput, n);
+            }, 2000);
+            printf("%-6d %-12s %10.2f\n", n, kEngineNames[e], us);
+        }
+    }
+}
+
+// Pruned-FFT cost model – the unit is one butterfly of a fully used stage in
+// prunedFFT().  Prints the measured ratios next to the constants that
+// updatePrunePlan() uses.
+static void benchPruneCosts(Host &host)
+{
+    auto *d = host.state();
+    static uint32_t masks[kMaxFftStages][kMaxFftSize / 64];
+    printf("\n%-6s %12s %12s %12s\n", "size", "sparse", "radix-2", "stockham");
+    for (int si = 0; si < kNumFftSizes; si++) {
+        host.set(kParamFftSize, si);
+        const int n = d->fftSize;
+        if (!isPowerOfTwo(n)) continue;
+        int stages = 0;
+        while ((2 << stages) <= n) stages++;
+        const int words = (n / 2 + 31) / 32;
+        const double butterflies = (double)(n / 2) * stages;
+
+        std::vector<Complex> frame(n);
+        srand(1);
+        for (int i = 0; i < n; i++) {
+            frame[i] = Complex(rand() / (float)RAND_MAX - 0.5f, 0.0f);
+        }
+        auto timeMasked = [&]() {
+            return timeTransform([&]() {
+                memcpy(d->fftOutput, frame.data(), sizeof(Complex) * n);
+                prunedFFT(d->fftOutput, d->cosTable, masks, n);
+            }, 2000);
+        };
+
+        // Every stage fully used: the plain loops
+        for (int s = 0; s < stages; s++) {
+            for (int w = 0; w < words; w++) masks[s][w] = 0xFFFFFFFFu;
+        }
+        const double unit = timeMasked() / butterflies;
+
+        // One butterfly short per stage: every stage takes the masked path
+        for (int s = 0; s < stages; s++) masks[s][0] &= ~1u;
+        const double sparse = timeMasked() / (butterflies - stages);
+
+        double engine[2];
+        for (int e = 0; e < 2; e++) {
+            host.set(kParamFftEngine, e);
+            engine[e] = timeTransform([&]() {
+                memcpy(d->fftOutput, frame.data(), sizeof(Complex) * n);
+                runFFT(d->fft, d->fftOutput, n);
+            }, 2000) / butterflies;
+        }
+        printf("%-6d %12.2f %12.2f %12.2f\n", n, sparse / unit, engine[0] / unit, engine[1] / unit);
+    }
+    printf("model  %12.2f %12.2f %12.2f\n", kPrunedSparseCost, kFullCostRadix2, kFullCostStockham);
+}
+
+int main()
+{
+    Host host;
+    benchEngines(host);
+    benchPruneCosts(host);
+    return 0;
+}
@@ -0,0 +1,123 @@
+// -----------------------------------------------------------------------------
+// Stress / fuzz driver – random parameter values, block sizes, input signals,
+// sample-rate switches, draw() and serialise() calls, reproducible from a
+// seed.  Fails on a non-finite output, and on more step() calls over their
+// deadline than allowed.
+//
+//   fuzz [seed] [iterations] [deadline factor] [allowed overruns]
+//
+// The host allows blocks of up to kMaxFrames, so every block size from 4 to
+// kMaxFrames frames is drawn.  A step() call's deadline is its block length
+// in real time, frames / sample rate, times the factor (0 = no timing).
+// Every call over its deadline is reported with the parameter values that
+// differ from their defaults; a negative allowance only reports them.
+//
+// make fuzz runs each seed twice: built with AddressSanitizer and UBSan,
+// so memory errors and undefined behaviour abort the run, without timing;
+// then uninstrumented at -O2 against the real deadline.
+// -----------------------------------------------------------------------------
+#include "host.h"
+#include <math.h>
+
+static const int kMaxFrames = 512;
+
+static uint32_t gSeed = 1;
+static uint32_t random32()
+{
+    gSeed ^= gSeed << 13;
+    gSeed ^= gSeed >> 17;
+    gSeed ^= gSeed << 5;
+    return gSeed;
+}
+static int randomInt(int lo, int hi) { return lo + (int)(random32() % (uint32_t)(hi - lo + 1)); }
+
+static void fillBus(float *x, int frames, int kind, long t)
+{
+    for (int n = 0; n < frames; n++) {
+        switch (kind) {
+        case 0:  x[n] = 0.0f; break;
+        case 1:  x[n] = 5.0f * sinf(0.01f * (float)((t + n) % 100000)); break;
+        case 2:  x[n] = (float)randomInt(-1000, 1000) / 100.0f; break;
+        default: x[n] = ((t + n) % 17 == 0) ? 10.0f : -10.0f; break;
+        }
+    }
+}
+
+static void printParameterState(const Host &host)
+{
+    printf("  parameters:");
+    for (int p = 0; p < (int)ARRAY_SIZE(gParameters); p++) {
+        if (host.v[p] != gParameters[p].def) printf(" %s=%d", gParameters[p].name, host.v[p]);
+    }
+    printf("\n");
+}
+
+int main(int argc, char **argv)
+{
+    const uint32_t seed = (argc > 1) ? (uint32_t)atoi(argv[1]) : 1;
+    const int iterations = (argc > 2) ? atoi(argv[2]) : 3000;
+    const double deadlineFactor = (argc > 3) ? atof(argv[3]) : 1.0;
+    const int allowedOverruns = (argc > 4) ? atoi(argv[4]) : 0;
+    gSeed = seed ? seed : 1;
+
+    static const uint32_t kRates[] = { 32000, 44100, 48000, 96000 };
+    const int numParams = (int)ARRAY_SIZE(gParameters);
+    hostSetMaxFramesPerStep(kMaxFrames);
+
+    Host host;
+    int overruns = 0;
+    double worstShare = 0.0;
+    long t = 0;
+    for (int it = 0; it < iterations; it++) {
+        const int action = randomInt(0, 99);
+        if (action < 30) {
+            int p = randomInt(0, numParams - 1);
+            host.set(p, randomInt(gParameters[p].min, gParameters[p].max));
+        } else if (action < 31) {
+            hostSetSampleRate(kRates[randomInt(0, 3)]);
+        } else if (action < 32) {
+            host.serialise();
+        }
+
+        const int framesBy4 = randomInt(1, kMaxFrames / 4);
+        host.begin(framesBy4);
+        for (int b = 1; b <= 28; b++) {
+            fillBus(host.ch(b), host.frames, randomInt(0, 3), t);
+        }
+        t += host.frames;
+
+        const double t0 = hostSeconds();
+        host.run();
+        const double us = (hostSeconds() - t0) * 1e6;
+        const double deadlineUs = 1e6 * host.frames / NT_globals.sampleRate * deadlineFactor;
+        if (deadlineFactor > 0.0 && us / deadlineUs > worstShare) worstShare = us / deadlineUs;
+        if (deadlineFactor > 0.0 && us > deadlineUs) {
+            printf("OVER: seed %u iteration %d framesBy4 %d at %u Hz: %.0f us, deadline %.0f us\n",
+                   seed, it, framesBy4, (unsigned)NT_globals.sampleRate, us, deadlineUs);
+            printParameterState(host);
+            overruns++;
+        }
+        if (randomInt(0, 4) == 0) gFactory.draw(host.alg);
+
+        for (size_t i = 0; i < host.bus.size(); i++) {
+            if (!isfinite(host.bus[i])) {
+                printf("FAIL: seed %u iteration %d: non-finite output on bus %d\n",
+                       seed, it, (int)(i / host.frames) + 1);
+                printParameterState(host);
+                return 1;
+            }
+        }
+    }
+
+    if (deadlineFactor <= 0.0) {
+        printf("seed %u: %d iterations ok\n", seed, iterations);
+        return 0;
+    }
+    printf("seed %u: %d iterations, worst step() %.0f%% of its deadline (factor %g), %d over\n",
+           seed, iterations, 100.0 * worstShare, deadlineFactor, overruns);
+    if (allowedOverruns >= 0 && overruns > allowedOverruns) {
+        printf("FAIL: more than %d calls over their deadline\n", allowedOverruns);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,152 @@
+// -----------------------------------------------------------------------------
+// Golden output check – renders fixed inputs through the bit-exact build
+// (SPECTRE_BIT_EXACT, -ffp-contract=off, no -ffast-math; see make golden)
+// for a set of configurations and compares a hash of every output bus with
+// the committed reference in tests/golden.txt.
+//
+//   golden <reference file>            compare, fail on any difference
+//   golden --update <reference file>   rewrite the reference
+//
+// The inputs are built from the plugin's own sine, so they are bit-identical
+// on every target too, and the same hashes check a module run.
+// -----------------------------------------------------------------------------
+#include "host.h"
+#include <string.h>
+
+#ifndef SPECTRE_BIT_EXACT
+#error "golden.cpp needs the bit-exact build (make golden)"
+#endif
+
+static const int kBlocks = 1500;
+static const int kFramesBy4 = 8;
+
+struct GoldenConfig {
+    const char *name;
+    uint32_t sampleRate;
+    int params[8][2];               // parameter, value; { 0, 0 } ends the list
+};
+
+// Every config also routes Band A Gate, Band B Trigger and Band C Hold,
+// unless it unroutes them
+static const GoldenConfig kConfigs[] = {
+    { "fft",             48000, { { 0, 0 } } },
+    { "reassign-peak",   48000, { { kParamReassign, 1 }, { kParamDetectionMode, 1 } } },
+    { "constant-q",      48000, { { kParamAnalysis, 1 } } },
+    { "polyphase",       48000, { { kParamAnalysis, 2 }, { kParamBandBSmooth, 1 } } },
+    { "adaptive",        48000, { { kParamWindowLength, kNumWindowLengths } } },
+    { "stockham-2048",   44100, { { kParamFftEngine, 1 }, { kParamFftSize, 6 } } },
+    { "mixed-radix-960", 48000, { { kParamFftSize, 3 } } },
+    { "pruned-band-a",   48000, { { kParamPruning, 2 }, { kParamCvOut2, 0 }, { kParamCvOut3, 0 },
+                                  { kParamTrigOut2, 0 }, { kParamHoldOut3, 0 } } },
+    { "decimated",       96000, { { kParamBandAFreq, 60 }, { kParamBandBFreq, 150 }, { kParamBandCFreq, 400 } } },
+    { "audio-outputs",   48000, { { kParamCarrierInput, 2 }, { kParamVocoderOut, 20 },
+                                  { kParamBandBOut, 21 }, { kParamDenoiseOut, 22 } } },
+};
+
+// FNV-1a over the bit patterns
+static uint64_t hashFloats(uint64_t h, const float *x, size_t n)
+{
+    for (size_t i = 0; i < n; i++) {
+        uint32_t u;
+        memcpy(&u, &x[i], sizeof(u));
+        for (int k = 0; k < 4; k++) {
+            h ^= (u >> (8 * k)) & 0xFF;
+            h *= 1099511628211ull;
+        }
+    }
+    return h;
+}
+
+// A drum-like pattern on bus 1 (decaying hits on three pitches under a
+// steady tone) and a sawtooth carrier on bus 2
+static uint64_t render(const GoldenConfig &config)
+{
+    hostSetSampleRate(config.sampleRate);
+    Host host;
+    host.set(kParamGateOut1, 16);
+    host.set(kParamTrigOut2, 17);
+    host.set(kParamHoldOut3, 18);
+    for (const auto &p : config.params) {
+        if (p[0] == 0 && p[1] == 0) break;
+        host.set(p[0], p[1]);
+    }
+
+    static const float kHitHz[3] = { 80.0f, 900.0f, 6000.0f };
+    const float twoPiOverRate = 2.0f * M_PI_F / (float)config.sampleRate;
+    uint64_t h = 14695981039346656037ull;
+    long t = 0;
+    for (int blk = 0; blk < kBlocks; blk++) {
+        host.begin(kFramesBy4);
+        for (int n = 0; n < host.frames; n++, t++) {
+            const int hit = (int)(t / 3000) % 3;
+            const float age = (float)(t % 3000);
+            const float decay = 1.0f - age / 3000.0f;
+            const float phase = (float)(t % 48000) * twoPiOverRate;
+            host.ch(1)[n] = 4.0f * decay * decay * sinf(kHitHz[hit] * phase)
+                          + 0.5f * sinf(440.0f * phase);
+            host.ch(2)[n] = (float)(t % 160) / 16.0f - 5.0f;
+        }
+        host.run();
+        h = hashFloats(h, host.bus.data(), host.bus.size());
+    }
+    return h;
+}
+
+int main(int argc, char **argv)
+{
+    const bool update = (argc > 2 && strcmp(argv[1], "--update") == 0);
+    const char *path = argv[argc - 1];
+    if (argc < 2) {
+        printf("usage: golden [--update] <reference file>\n");
+        return 2;
+    }
+
+    if (update) {
+        FILE *f = fopen(path, "w");
+        if (!f) {
+            printf("cannot write %s\n", path);
+            return 1;
+        }
+        fprintf(f, "# make golden: FNV-1a 64 of every bus, %d blocks of %d frames, bit-exact build\n",
+                kBlocks, kFramesBy4 * 4);
+        for (const auto &config : kConfigs) {
+            fprintf(f, "%s %016llx\n", config.name, (unsigned long long)render(config));
+        }
+        fclose(f);
+        printf("wrote %s\n", path);
+        return 0;
+    }
+
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        printf("cannot read %s\n", path);
+        return 1;
+    }
+    int failures = 0;
+    int checked = 0;
+    char line[256];
+    while (fgets(line, sizeof(line), f)) {
+        char name[64];
+        unsigned long long expected;
+        if (line[0] == '#' || sscanf(line, "%63s %llx", name, &expected) != 2) continue;
+        const GoldenConfig *config = nullptr;
+        for (const auto &c : kConfigs) {
+            if (strcmp(c.name, name) == 0) config = &c;
+        }
+        if (!config) {
+            printf("%-16s unknown config\n", name);
+            failures++;
+            continue;
+        }
+        const unsigned long long got = render(*config);
+        printf("%-16s %016llx %s\n", name, got, (got == expected) ? "ok" : "DIFFERS");
+        if (got != expected) failures++;
+        checked++;
+    }
+    fclose(f);
+    if (checked != (int)ARRAY_SIZE(kConfigs)) {
+        printf("FAIL: %d of %d configs in %s\n", checked, (int)ARRAY_SIZE(kConfigs), path);
+        return 1;
+    }
+    return failures ? 1 : 0;
+}
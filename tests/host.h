@@ -0,0 +1,149 @@
+// -----------------------------------------------------------------------------
+// Host test support – a minimal Disting NT host for the drivers in tests/.
+// -----------------------------------------------------------------------------
+// The plugin is a single translation unit with internal linkage, so each
+// driver includes it directly and gets every static function and constant.
+// This file supplies the API globals and callbacks the module firmware would
+// provide and a Host that allocates the memory blocks, sets parameters and
+// runs step() on a 28-bus frame buffer.
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+#include <chrono>
+
+#include "../spectralEnvFollower.cpp"
+
+static _NT_globals hostGlobals()
+{
+    _NT_globals g = {};
+    g.sampleRate = 48000;
+    g.maxFramesPerStep = 128;
+    return g;
+}
+extern const _NT_globals NT_globals = hostGlobals();
+
+static inline void hostSetSampleRate(uint32_t sampleRate)
+{
+    const_cast<_NT_globals &>(NT_globals).sampleRate = sampleRate;
+}
+
+static inline void hostSetMaxFramesPerStep(uint32_t frames)
+{
+    const_cast<_NT_globals &>(NT_globals).maxFramesPerStep = frames;
+}
+
+uint8_t NT_screen[128 * 64];
+
+void NT_drawText(int, int, const char *, int, _NT_textAlignment, _NT_textSize) {}
+void NT_drawShapeI(_NT_shape, int, int, int, int, int) {}
+void NT_drawShapeF(_NT_shape, float, float, float, float, float) {}
+int NT_intToString(char *buffer, int32_t value) { return sprintf(buffer, "%d", (int)value); }
+int NT_floatToString(char *buffer, float value, int decimalPlaces) { return sprintf(buffer, "%.*f", decimalPlaces, value); }
+int32_t NT_algorithmIndex(const _NT_algorithm *) { return 0; }
+uint32_t NT_parameterOffset(void) { return 0; }
+
+struct Host;
+static Host *gHost = nullptr;
+
+// serialise() output, flattened: member names and numbers in stream order
+static std::vector<std::string> gJsonNames;
+static std::vector<int> gJsonNumbers;
+
+void _NT_jsonStream::openArray() {}
+void _NT_jsonStream::closeArray() {}
+void _NT_jsonStream::openObject() {}
+void _NT_jsonStream::closeObject() {}
+void _NT_jsonStream::addMemberName(const char *name) { gJsonNames.push_back(name); }
+void _NT_jsonStream::addNumber(int value) { gJsonNumbers.push_back(value); }
+void _NT_jsonStream::addNumber(float value) { gJsonNumbers.push_back((int)value); }
+void _NT_jsonStream::addString(const char *) {}
+void _NT_jsonStream::addFourCC(uint32_t) {}
+void _NT_jsonStream::addBoolean(bool) {}
+void _NT_jsonStream::addNull() {}
+
+bool _NT_jsonParse::numberOfObjectMembers(int &num) { num = 0; return true; }
+bool _NT_jsonParse::numberOfArrayElements(int &num) { num = 0; return true; }
+bool _NT_jsonParse::matchName(const char *) { return false; }
+bool _NT_jsonParse::skipMember() { return true; }
+bool _NT_jsonParse::number(int &) { return false; }
+bool _NT_jsonParse::number(float &) { return false; }
+bool _NT_jsonParse::string(const char *&) { return false; }
+bool _NT_jsonParse::boolean(bool &) { return false; }
+bool _NT_jsonParse::null() { return false; }
+
+struct Host {
+    _NT_algorithmRequirements req = {};
+    std::vector<uint8_t> sram, dram, dtc, itc;
+    std::vector<int16_t> v;
+    std::vector<float> bus;
+    _NT_algorithm *alg = nullptr;
+    int frames = 0;
+
+    Host()
+    {
+        std::vector<int32_t> specs;
+        for (uint32_t i = 0; i < gFactory.numSpecifications; ++i) {
+            specs.push_back(gFactory.specifications[i].def);
+        }
+        gFactory.calculateRequirements(req, specs.data());
+        // Garbage-filled blocks, so construct() must initialise everything
+        sram.assign(req.sram, 0xCD);
+        dram.assign(req.dram, 0xCD);
+        dtc.assign(req.dtc, 0xCD);
+        itc.assign(req.itc + 1, 0xCD);
+        _NT_algorithmMemoryPtrs mem = { sram.data(), dram.data(), dtc.data(), itc.data() };
+        alg = gFactory.construct(mem, req, specs.data());
+        v.resize(req.numParameters);
+        for (uint32_t i = 0; i < req.numParameters; ++i) {
+            v[i] = alg->parameters[i].def;
+        }
+        alg->v = v.data();
+        alg->vIncludingCommon = v.data();
+        gHost = this;
+        for (uint32_t i = 0; i < req.numParameters; ++i) {
+            gFactory.parameterChanged(alg, (int)i);
+        }
+    }
+
+    _SpectralEnvFollower_DTC *state() { return ((_SpectralEnvFollower *)alg)->dtc; }
+
+    void set(int p, int value)
+    {
+        v[p] = (int16_t)value;
+        gFactory.parameterChanged(alg, p);
+    }
+
+    // Size the bus for a block and clear it; fill inputs with ch(), then run()
+    void begin(int framesBy4)
+    {
+        frames = framesBy4 * 4;
+        bus.assign((size_t)28 * frames, 0.0f);
+    }
+    float *ch(int busNumber) { return bus.data() + (size_t)(busNumber - 1) * frames; }
+    void run() { gFactory.step(alg, bus.data(), frames / 4); }
+
+    // serialise() into gJsonNames / gJsonNumbers.  The stubs above never
+    // touch the stream object itself, so no particular constructor is needed.
+    void serialise()
+    {
+        gJsonNames.clear();
+        gJsonNumbers.clear();
+        alignas(_NT_jsonStream) unsigned char storage[sizeof(_NT_jsonStream)];
+        gFactory.serialise(alg, *reinterpret_cast<_NT_jsonStream *>(storage));
+    }
+};
+
+void NT_setParameterFromUi(uint32_t, uint32_t p, int16_t value)
+{
+    if (gHost) gHost->set((int)p, value);
+}
+void NT_setParameterFromAudio(uint32_t a, uint32_t p, int16_t value) { NT_setParameterFromUi(a, p, value); }
+
+static inline double hostSeconds()
+{
+    using namespace std::chrono;
+    return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
@@ -0,0 +1,31 @@
+// -----------------------------------------------------------------------------
+// DRAM layout – prints the compile-time plan by subsystem, in the form of the
+// README Memory Usage table.
+// -----------------------------------------------------------------------------
+#include "host.h"
+
+static const char *const kGroupNames[kNumLayoutGroups] = {
+    "Analysis (input ring, FFT, windows, band plans)",
+    "Resynthesis (overlap-add)",
+    "Freeze, denoise and vocoder",
+    "Constant-Q kernel",
+    "Reassignment",
+    "Polyphase",
+    "Max hold and scope",
+    "Trace recorder",
+};
+
+int main()
+{
+    uint32_t sum = 0;
+    for (int g = 0; g < kNumLayoutGroups; g++) {
+        printf("| %s | %u |\n", kGroupNames[g], kDramLayout.groupBytes[g]);
+        sum += kDramLayout.groupBytes[g];
+    }
+    printf("| **Total** | **%u** |\n", kDramLayout.total);
+    if (sum != kDramLayout.total) {
+        printf("FAIL: groups sum to %u\n", sum);
+        return 1;
+    }
+    return 0;
+}
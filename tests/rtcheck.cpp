@@ -0,0 +1,183 @@
+// -----------------------------------------------------------------------------
+// Real-time safety check – counts heap allocations, mutex calls and libm
+// transcendental calls made inside step(), for a set of configurations that
+// between them exercise every analysis mode and output.  The allocator, the
+// mutex calls and libm are interposed with the linker's --wrap (see the
+// Makefile); operator new/delete are replaced here.  Any allocation or lock
+// in step(), or any libm call in a steady-state block, fails the check.
+// The blocks after a sample-rate switch are reported separately: they
+// re-derive the bin plans and rebuild the constant-Q kernel, which does call
+// libm.
+// -----------------------------------------------------------------------------
+#include "host.h"
+#include <new>
+#include <pthread.h>
+
+static bool gInStep = false;
+
+// One counter per wrapped symbol, in the Makefile's RT_WRAPPED order, plus
+// operator new/delete
+enum {
+    kRtMalloc, kRtCalloc, kRtRealloc, kRtFree, kRtMutexLock,
+    kRtExpf, kRtExp2f, kRtLogf, kRtLog2f, kRtLog10f, kRtSinf, kRtCosf, kRtTanf, kRtAtanf,
+    kRtPowf, kRtAtan2f, kRtFmodf,
+    kRtNew, kRtDelete,
+    kNumRtCounters,
+    kFirstRtMath = kRtExpf, kLastRtMath = kRtFmodf,
+};
+static const char *const kRtNames[kNumRtCounters] = {
+    "malloc", "calloc", "realloc", "free", "pthread_mutex_lock",
+    "expf", "exp2f", "logf", "log2f", "log10f", "sinf", "cosf", "tanf", "atanf",
+    "powf", "atan2f", "fmodf",
+    "new", "delete",
+};
+static long gCounts[kNumRtCounters];
+
+static inline void rtCount(int which)
+{
+    if (gInStep) gCounts[which]++;
+}
+
+extern "C" {
+void *__real_malloc(size_t);
+void *__real_calloc(size_t, size_t);
+void *__real_realloc(void *, size_t);
+void __real_free(void *);
+void *__wrap_malloc(size_t n) { rtCount(kRtMalloc); return __real_malloc(n); }
+void *__wrap_calloc(size_t n, size_t m) { rtCount(kRtCalloc); return __real_calloc(n, m); }
+void *__wrap_realloc(void *p, size_t n) { rtCount(kRtRealloc); return __real_realloc(p, n); }
+void __wrap_free(void *p) { rtCount(kRtFree); __real_free(p); }
+
+int __real_pthread_mutex_lock(pthread_mutex_t *);
+int __wrap_pthread_mutex_lock(pthread_mutex_t *m) { rtCount(kRtMutexLock); return __real_pthread_mutex_lock(m); }
+
+#define RT_WRAP1(name, which) \
+    float __real_##name(float); \
+    float __wrap_##name(float x) { rtCount(which); return __real_##name(x); }
+#define RT_WRAP2(name, which) \
+    float __real_##name(float, float); \
+    float __wrap_##name(float x, float y) { rtCount(which); return __real_##name(x, y); }
+RT_WRAP1(expf, kRtExpf) RT_WRAP1(exp2f, kRtExp2f) RT_WRAP1(logf, kRtLogf) RT_WRAP1(log2f, kRtLog2f)
+RT_WRAP1(log10f, kRtLog10f) RT_WRAP1(sinf, kRtSinf) RT_WRAP1(cosf, kRtCosf) RT_WRAP1(tanf, kRtTanf)
+RT_WRAP1(atanf, kRtAtanf)
+RT_WRAP2(powf, kRtPowf) RT_WRAP2(atan2f, kRtAtan2f) RT_WRAP2(fmodf, kRtFmodf)
+}
+
+void *operator new(size_t n) { rtCount(kRtNew); return __real_malloc(n ? n : 1); }
+void *operator new[](size_t n) { rtCount(kRtNew); return __real_malloc(n ? n : 1); }
+void operator delete(void *p) noexcept { rtCount(kRtDelete); __real_free(p); }
+void operator delete[](void *p) noexcept { rtCount(kRtDelete); __real_free(p); }
+void operator delete(void *p, size_t) noexcept { rtCount(kRtDelete); __real_free(p); }
+void operator delete[](void *p, size_t) noexcept { rtCount(kRtDelete); __real_free(p); }
+
+struct RtCounts {
+    long calls[kNumRtCounters];
+
+    long math() const
+    {
+        long n = 0;
+        for (int i = kFirstRtMath; i <= kLastRtMath; i++) n += calls[i];
+        return n;
+    }
+    long other() const { return total() - math(); }     // allocations and locks
+    long total() const
+    {
+        long n = 0;
+        for (long c : calls) n += c;
+        return n;
+    }
+    void print(const char *phase) const
+    {
+        printf("    %-12s", phase);
+        if (!total()) printf(" none");
+        for (int i = 0; i < kNumRtCounters; i++) {
+            if (calls[i]) printf(" %s=%ld", kRtNames[i], calls[i]);
+        }
+        printf("\n");
+    }
+};
+
+// Run blocks of a pulsing tone (bus 1) and carrier (bus 2), counting calls
+static RtCounts runBlocks(Host &host, int blocks, long &t)
+{
+    memset(gCounts, 0, sizeof(gCounts));
+    for (int blk = 0; blk < blocks; blk++) {
+        host.begin(32);
+        for (int n = 0; n < host.frames; n++, t++) {
+            float amp = (blk % 50 < 5) ? 1.0f : 0.5f;
+            host.ch(1)[n] = amp * sinf(0.1309f * (float)(t % 48000));
+            host.ch(2)[n] = 0.3f * sinf(0.3f * (float)(t % 10000));
+            host.ch(3)[n] = (blk % 100 < 50) ? 5.0f : 0.0f;
+        }
+        gInStep = true;
+        host.run();
+        gInStep = false;
+    }
+    RtCounts counts;
+    memcpy(counts.calls, gCounts, sizeof(gCounts));
+    return counts;
+}
+
+static void configure(Host &host, int cfg)
+{
+    switch (cfg) {
+    case 0: host.set(kParamPruning, 2); break;
+    case 1: host.set(kParamReassign, 1); break;
+    case 2: host.set(kParamAnalysis, 1); break;
+    case 3:
+        host.set(kParamBandBOut, 20);
+        host.set(kParamFreezeGate, 3);
+        host.set(kParamFreezeOut, 21);
+        host.set(kParamDenoiseOut, 22);
+        host.set(kParamCarrierInput, 2);
+        host.set(kParamVocoderOut, 23);
+        break;
+    case 4:
+        host.set(kParamWindowLength, kNumWindowLengths);   // Adaptive
+        host.set(kParamTrigOut1, 24);
+        host.set(kParamHoldOut2, 25);
+        host.set(kParamShareOut1, 26);
+        host.set(kParamLoudestOut, 27);
+        break;
+    case 5:
+        host.set(kParamAnalysis, 2);
+        host.set(kParamDetectionMode, 1);
+        host.set(kParamBandBSmooth, 1);
+        host.set(kParamGateOut1, 24);
+        break;
+    case 6:
+        host.set(kParamTrace, 1);
+        host.set(kParamFftSize, 2);
+        host.set(kParamFftEngine, 1);
+        break;
+    }
+}
+
+static const char *const kConfigNames[] = {
+    "fft + pruning", "reassign", "constant-q", "audio outputs", "adaptive + cross-band", "polyphase + 2-pole", "trace + stockham",
+};
+
+int main()
+{
+    int failures = 0;
+    for (int cfg = 0; cfg < (int)ARRAY_SIZE(kConfigNames); cfg++) {
+        hostSetSampleRate(48000);
+        Host host;
+        host.set(kParamCvOut1, 13);
+        configure(host, cfg);
+        long t = 0;
+        RtCounts steady = runBlocks(host, 400, t);
+
+        hostSetSampleRate(96000);
+        RtCounts rate = runBlocks(host, 200, t);
+        RtCounts after = runBlocks(host, 200, t);
+
+        const bool ok = !steady.total() && !rate.other() && !after.total();
+        printf("%-22s %s\n", kConfigNames[cfg], ok ? "ok" : "FAIL");
+        steady.print("steady");
+        rate.print("rate switch");
+        after.print("after");
+        if (!ok) failures++;
+    }
+    return failures ? 1 : 0;
+}